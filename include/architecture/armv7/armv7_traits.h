@@ -12,12 +12,17 @@ template<> struct Traits<CPU>: public Traits<Build>
     static const unsigned int WORD_SIZE         = 32;
     static const unsigned int CLOCK             = (MODEL == LM3S811) ? 50000000 : (MODEL == Zynq) ? 666666687 : (MODEL == Realview_PBX) ? 100000000 : 1400000000L;
     static const bool unaligned_memory_access   = false;
+    static const unsigned int CACHE_LINE_SIZE   = 32;
 };
 
 template<> struct Traits<MMU>: public Traits<Build>
 {
-    static const bool colorful = false;
-    static const unsigned int COLORS = 1;
+    static const unsigned int COLORS = 1; // no page coloring
+
+    // Buddy-system frame allocator (O(log n) alloc/free, power-of-two requests come naturally aligned)
+    static const bool buddy = false;
+    static const unsigned int ORDERS = 11; // blocks of up to 2^10 frames
+    static const bool huge_pages = false; // only SV39 maps huge pages
 };
 
 template<> struct Traits<FPU>: public Traits<Build>
@@ -43,6 +48,7 @@ template<> struct Traits<TSC>: public Traits<Build>
 template<> struct Traits<PMU>: public Traits<Build>
 {
     static const bool enabled = (Traits<Build>::MODEL == Traits<Build>::Raspberry_Pi3);
+    static const unsigned int VIRTUAL_CHANNELS = 6; // channels saved and restored for threads that enable PMU virtualization
 };
 
 __END_SYS
@@ -603,6 +603,8 @@ public:
         return ctx;
     }
 
+    using CPU_Common::fence;
+
     using CPU_Common::htole64;
     using CPU_Common::htole32;
     using CPU_Common::htole16;
@@ -139,6 +139,9 @@ public:
         return old;
     }
 
+    // Full memory barrier: accesses before it become visible to other CPUs before any access after it
+    static void fence() { __sync_synchronize(); }
+
     template <int (* finc)(volatile int &)>
     static void smp_barrier(unsigned int cores, unsigned int id) {
         if(cores > 1) {
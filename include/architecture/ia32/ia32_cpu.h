@@ -95,6 +95,7 @@ public:
 
     // CR4 Flags
     enum {
+        CR4_PGE     = 1 << 7,   // CR4 Page Global Enable (GLB mappings survive CR3 reloads)
         CR4_PSE     = 1 << 8    // CR4 Performance Counter Enable
     };
 
@@ -416,6 +417,8 @@ public:
     static void flush_tlb() { ASM("movl %cr3, %eax"); ASM("movl %eax, %cr3"); }
     static void flush_tlb(Reg32 r) { ASM("invlpg %0" : : "m"(r)); }
 
+    using CPU_Common::fence;
+
     static Reg64 htole64(Reg64 v) { return v; }
     static Reg32 htole32(Reg32 v) { return v; }
     static Reg16 htole16(Reg16 v) { return v; }
@@ -5,6 +5,7 @@
 
 #include <architecture/mmu.h>
 #include <system/memory_map.h>
+#include <utility/buddy.h>
 
 __BEGIN_SYS
 
@@ -17,8 +18,10 @@ private:
     typedef Grouping_List<Frame> List;
     typedef MMU_Common<10, 10, 12> Common;
 
-    static const bool colorful = Traits<MMU>::colorful;
+    static const bool colorful = Traits<System>::colorful;
     static const unsigned int COLORS = Traits<MMU>::COLORS;
+    static const bool buddy = Traits<MMU>::buddy; // for the WHITE frames, colored ones are still kept in lists
+    static const unsigned long FRAMES = (Memory_Map::RAM_TOP + 1 - Memory_Map::RAM_BASE) / PG_SIZE;
     static const unsigned int RAM_BASE  = Memory_Map::RAM_BASE;
     static const unsigned int APP_LOW   = Memory_Map::APP_LOW;
     static const unsigned int APP_HIGH  = Memory_Map::APP_HIGH;
@@ -26,6 +29,8 @@ private:
     static const unsigned int SYS       = Memory_Map::SYS;
     static const unsigned int SYS_HIGH  = Memory_Map::SYS_HIGH;
 
+    typedef Buddy_Allocator<MMU, Memory_Map::RAM_BASE, buddy ? FRAMES : 1, PG_SIZE, Traits<MMU>::ORDERS> Buddy;
+
 public:
     // Page Flags
     class Page_Flags
@@ -48,6 +53,7 @@ public:
             APPC = (PRE | EX  | ACC | USR),
             APPD = (PRE | WR  | ACC | USR),
             SYS  = (PRE | WR  | ACC),
+            GSYS = (SYS | GLB), // system mappings, equal in all address spaces
             PCI  = (SYS | PCD | IO),
             APIC = (SYS | PCD),
             VGA  = (SYS | PCD),
@@ -169,6 +175,22 @@ public:
             _pt->remap(phy_addr, _from, _to, flags);
         }
 
+        // Page faults are not handled, so clones are eager copies (and Flags::LZ is ignored), except for I/O ones,
+        // which just alias the same device memory (and, as any I/O chunk, free no frames when deleted)
+        Chunk(const Chunk * source)
+        : _free(true), _from(0), _to(source->_to - source->_from), _pts(Common::pts(_to - _from)), _flags(source->_flags), _pt(calloc(_pts, WHITE)) {
+            if(_flags & Page_Flags::IO)
+                _pt->remap(pte2phy((*source->_pt)[source->_from]), _from, _to, _flags);
+            else {
+                if(_flags & Page_Flags::CT)
+                    _pt->map_contiguous(_from, _to, _flags, WHITE);
+                else
+                    _pt->map(_from, _to, _flags, WHITE);
+                for(unsigned int i = _from; i < _to; i++)
+                    memcpy(phy2log(pte2phy((*_pt)[i])), phy2log(pte2phy((*source->_pt)[source->_from + i])), sizeof(Page));
+            }
+        }
+
         ~Chunk() {
             if(_free) {
                 if(!(_flags & Page_Flags::IO)) {
@@ -374,11 +396,16 @@ public:
         Phy_Addr phy(false);
 
         if(frames) {
-            List::Element * e = _free[color].search_decrementing(frames);
-            if(e) {
-                phy = e->object() + e->size();
+            if(buddy && (color == WHITE))
+                phy = _buddy.alloc(frames);
+            else {
+                List::Element * e = _free[color].search_decrementing(frames);
+                if(e)
+                    phy = e->object() + e->size();
+            }
+            if(phy)
                 db<MMU>(TRC) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => " << phy << endl;
-            } else
+            else
                 if(colorful)
                     db<MMU>(INF) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
                 else
@@ -401,7 +428,10 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << color << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy && (color == WHITE)) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[color].insert_merging(e, &m1, &m2);
@@ -414,14 +444,32 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << WHITE << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[WHITE].insert_merging(e, &m1, &m2);
         }
     }
 
-    static unsigned long allocable(Color color = WHITE) { return _free[color].head() ? _free[color].head()->size() : 0; }
+    static unsigned long allocable(Color color = WHITE) {
+        if(buddy && (color == WHITE))
+            return _buddy.allocable();
+        return _free[color].head() ? _free[color].head()->size() : 0;
+    }
+
+    // Number of free blocks of 2^order frames in the buddy system (always 0 without it)
+    static unsigned long free_blocks(unsigned int order) { return buddy ? _buddy.blocks(order) : 0; }
+
+    // Number of free frames, in all colors (allocable() is only the largest block)
+    static unsigned long free_frames() {
+        unsigned long frames = buddy ? _buddy.size() : _free[WHITE].grouped_size();
+        for(unsigned int i = 1; i < colorful * COLORS + 1; i++)
+            frames += _free[i].grouped_size();
+        return frames;
+    }
 
     static Page_Directory * volatile current() { return static_cast<Page_Directory * volatile>(pd()); }
 
@@ -431,6 +479,8 @@ public:
         return pt->log()[pti(addr)] | off(addr);
     }
 
+    static bool fault(Log_Addr addr, bool write) { return false; } // there are no lazy or copy-on-write pages to map
+
     static PT_Entry phy2pte(Phy_Addr frame, Page_Flags flags) { return frame | flags; }
     static Phy_Addr pte2phy(PT_Entry entry) { return (entry & ~Page_Flags::MASK); }
     static Page_Flags pte2flg(PT_Entry entry) { return (entry & Page_Flags::MASK); }
@@ -447,14 +497,15 @@ public:
     static Phy_Addr log2phy(Log_Addr log) { return Phy_Addr((RAM_BASE == PHY_MEM) ? log : (RAM_BASE > PHY_MEM) ? log + (RAM_BASE - PHY_MEM) : log - (PHY_MEM - RAM_BASE)); }
 #endif
 
-    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? ((phy >> PT_SHIFT) & 0x7f) % COLORS : WHITE); } // TODO: what is 0x7f
+    // The color of a frame is given by the LLC set index bits right above the page offset
+    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? (phy >> PT_SHIFT) & (COLORS - 1) : WHITE); }
 
     static Color log2color(Log_Addr log) {
         if(colorful) {
             Page_Directory * pd = current();
             Page_Table * pt = pd->log()[pdi(log)];
             Phy_Addr phy = pt->log()[pti(log)] | off(log);
-            return static_cast<Color>(((phy >> PT_SHIFT) & 0x7f) % COLORS);
+            return phy2color(phy);
         } else
             return WHITE;
     }
@@ -469,7 +520,8 @@ private:
     static void init();
 
 private:
-    static List _free[colorful * COLORS + 1]; // +1 for WHITE
+    static List _free[colorful * COLORS + 1]; // +1 for WHITE (unused if buddy)
+    static Buddy _buddy;
     static Page_Directory * _master;
 };
 
@@ -13,6 +13,7 @@ template<> struct Traits<CPU>: public Traits<Build>
     static const unsigned int WORD_SIZE         = 32;
     static const unsigned int CLOCK             = 2000000000;
     static const bool unaligned_memory_access   = true;
+    static const unsigned int CACHE_LINE_SIZE   = 64;
 };
 
 template<> struct Traits<TSC>: public Traits<Build>
@@ -21,8 +22,16 @@ template<> struct Traits<TSC>: public Traits<Build>
 
 template<> struct Traits<MMU>: public Traits<Build>
 {
-    static const bool colorful = false;
-    static const unsigned int COLORS = 1;
+    // Page coloring (Traits<System>::colorful) partitions the last-level cache by the physical address bits above the page
+    // offset that index its sets
+    static const unsigned int LLC_SIZE = 2 * 1024 * 1024; // typical shared L2/L3 slice
+    static const unsigned int LLC_WAYS = 16;
+    static const unsigned int COLORS = LLC_SIZE / LLC_WAYS / 4096; // a power of 2, up to 32 (see Color)
+
+    // Buddy-system frame allocator (O(log n) alloc/free, power-of-two requests come naturally aligned)
+    static const bool buddy = true; // MMU::init() keeps the pages INIT runs from out of it
+    static const unsigned int ORDERS = 11; // blocks of up to 2^10 frames
+    static const bool huge_pages = false; // only SV39 maps huge pages
 };
 
 template<> struct Traits<FPU>: public Traits<Build>
@@ -36,6 +45,7 @@ template<> struct Traits<PMU>: public Traits<Build>
     static const bool enabled = true;
     enum { V1, V2, V3, DUO, MICRO, ATOM, SANDY_BRIDGE };
     static const unsigned int VERSION = SANDY_BRIDGE;
+    static const unsigned int VIRTUAL_CHANNELS = 7; // channels saved and restored for threads that enable PMU virtualization
 };
 
 __END_SYS
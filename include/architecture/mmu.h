@@ -70,6 +70,7 @@ public:
             IO   = 1 << 11, // Memory Mapped I/O (0=memory, 1=I/O)
             CT   = 1 << 12, // Contiguous (0=non-contiguous, 1=contiguous)
             SPE  = 1 << 13,
+            LZ   = 1 << 14, // Lazy (frames are allocated and zeroed on first access, on MMUs that handle page faults)
             SYSC = (PRE | RD | EX),
             SYSD = (PRE | RD | WR),
             APPC = (PRE | RD | EX | USR),
@@ -158,8 +159,9 @@ public:
         Chunk(Phy_Addr phy_addr, unsigned long bytes, Flags flags):  _free(false), _phy_addr(phy_addr), _bytes(bytes), _flags(flags) {}
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags):_free(false), _phy_addr(0), _bytes(to - from), _flags(flags) {}
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags, Phy_Addr phy_addr): _free(false), _phy_addr(phy_addr), _bytes(to - from), _flags(flags) {}
+        Chunk(const Chunk * source): _free(true), _phy_addr(alloc(source->_bytes)), _bytes(source->_bytes), _flags(source->_flags) { memcpy(_phy_addr, source->_phy_addr, _bytes); } // no paging, so clones are eager copies
 
-        ~Chunk() { if(_free) free(_phy_addr, _bytes); }
+        ~Chunk() { if(_free && _phy_addr) free(_phy_addr, _bytes); } // alloc() might have failed
 
         unsigned int pts() const { return 0; }
         Flags flags() const { return _flags; }
@@ -267,11 +269,15 @@ public:
     }
 
     static unsigned long allocable(Color color = WHITE) { return _free.head() ? _free.head()->size() : 0; }
+    static unsigned long free_blocks(unsigned int order) { return 0; } // no buddy system without frames
+    static unsigned long free_frames() { return _free.grouped_size(); } // frames are bytes
 
     static Page_Directory * volatile current() { return 0; }
 
     static Phy_Addr physical(Log_Addr addr) { return addr; }
 
+    static bool fault(Log_Addr addr, bool write) { return false; } // there are no lazy or copy-on-write pages to map
+
     static PT_Entry phy2pte(Phy_Addr frame, Flags flags) { return frame; }
     static Phy_Addr pte2phy(PT_Entry entry) { return entry; }
     static PD_Entry phy2pde(Phy_Addr frame) { return frame; }
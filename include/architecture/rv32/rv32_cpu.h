@@ -288,6 +288,8 @@ public:
     static void flush_tlb() {         ASM("sfence.vma"    : :           : "memory"); }
     static void flush_tlb(Reg addr) { ASM("sfence.vma %0" : : "r"(addr) : "memory"); }
 
+    using CPU_Common::fence;
+
     using CPU_Common::htole64;
     using CPU_Common::htole32;
     using CPU_Common::htole16;
@@ -7,6 +7,7 @@
 #include <architecture/mmu.h>
 #undef __mmu_common_only__
 #include <system/memory_map.h>
+#include <utility/buddy.h>
 
 __BEGIN_SYS
 
@@ -19,13 +20,17 @@ private:
     typedef Grouping_List<Frame> List;
     typedef MMU_Common<10, 10, 12> Common;
 
-    static const bool colorful = Traits<MMU>::colorful;
+    static const bool colorful = Traits<System>::colorful;
     static const unsigned long COLORS = Traits<MMU>::COLORS;
+    static const bool buddy = Traits<MMU>::buddy; // for the WHITE frames, colored ones are still kept in lists
+    static const unsigned long FRAMES = (Memory_Map::RAM_TOP + 1 - Memory_Map::RAM_BASE) / PG_SIZE;
     static const unsigned long RAM_BASE = Memory_Map::RAM_BASE;
     static const unsigned long PHY_MEM = Memory_Map::PHY_MEM;
     static const unsigned long APP_LOW = Memory_Map::APP_LOW;
     static const unsigned long APP_HIGH = Memory_Map::APP_HIGH;
 
+    typedef Buddy_Allocator<SV32_MMU, Memory_Map::RAM_BASE, buddy ? FRAMES : 1, PG_SIZE, Traits<MMU>::ORDERS> Buddy;
+
 public:
     // Page Flags
     class Page_Flags
@@ -185,6 +190,22 @@ public:
             _pt->remap(phy_addr, _from, _to, flags);
         }
 
+        // Page faults are not handled, so clones are eager copies (and Flags::LZ is ignored), except for I/O ones,
+        // which just alias the same device memory (and, as any I/O chunk, free no frames when deleted)
+        Chunk(const Chunk * source)
+        : _free(true), _from(0), _to(source->_to - source->_from), _pts(Common::pts(_to - _from)), _flags(source->_flags), _pt(calloc(_pts, WHITE)) {
+            if(_flags & Page_Flags::IO)
+                _pt->remap(pte2phy((*source->_pt)[source->_from]), _from, _to, _flags);
+            else {
+                if(_flags & Page_Flags::CT)
+                    _pt->map_contiguous(_from, _to, _flags, WHITE);
+                else
+                    _pt->map(_from, _to, _flags, WHITE);
+                for(unsigned int i = _from; i < _to; i++)
+                    memcpy(phy2log(pte2phy((*_pt)[i])), phy2log(pte2phy((*source->_pt)[source->_from + i])), sizeof(Page));
+            }
+        }
+
         ~Chunk() {
             if(_free) {
                 if(!(_flags & Page_Flags::IO)) {
@@ -408,11 +429,16 @@ public:
         Phy_Addr phy(false);
 
         if(frames) {
-            List::Element * e = _free[color].search_decrementing(frames);
-            if(e) {
-                phy = e->object() + e->size();
+            if(buddy && (color == WHITE))
+                phy = _buddy.alloc(frames);
+            else {
+                List::Element * e = _free[color].search_decrementing(frames);
+                if(e)
+                    phy = e->object() + e->size();
+            }
+            if(phy)
                 db<MMU>(TRC) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => " << phy << endl;
-            } else
+            else
                 if(colorful)
                     db<MMU>(INF) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
                 else
@@ -435,7 +461,10 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << color << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy && (color == WHITE)) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[color].insert_merging(e, &m1, &m2);
@@ -448,14 +477,32 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << WHITE << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[WHITE].insert_merging(e, &m1, &m2);
         }
     }
 
-    static unsigned long allocable(Color color = WHITE) { return _free[color].head() ? _free[color].head()->size() : 0; }
+    static unsigned long allocable(Color color = WHITE) {
+        if(buddy && (color == WHITE))
+            return _buddy.allocable();
+        return _free[color].head() ? _free[color].head()->size() : 0;
+    }
+
+    // Number of free blocks of 2^order frames in the buddy system (always 0 without it)
+    static unsigned long free_blocks(unsigned int order) { return buddy ? _buddy.blocks(order) : 0; }
+
+    // Number of free frames, in all colors (allocable() is only the largest block)
+    static unsigned long free_frames() {
+        unsigned long frames = buddy ? _buddy.size() : _free[WHITE].grouped_size();
+        for(unsigned int i = 1; i < colorful * COLORS + 1; i++)
+            frames += _free[i].grouped_size();
+        return frames;
+    }
 
     static Page_Directory * volatile current() { return static_cast<Page_Directory * volatile>(pd()); }
 
@@ -465,6 +512,8 @@ public:
         return pt->log()[pti(addr)] | off(addr);
     }
 
+    static bool fault(Log_Addr addr, bool write) { return false; } // there are no lazy or copy-on-write pages to map
+
     static PT_Entry phy2pte(Phy_Addr frame, Page_Flags flags) { return (frame >> 2) | flags; }
     static Phy_Addr pte2phy(PT_Entry entry) { return (entry & ~Page_Flags::MASK) << 2; }
     static PD_Entry phy2pde(Phy_Addr frame) { return (frame >> 2) | Page_Flags::V; }
@@ -479,14 +528,14 @@ public:
     static Phy_Addr log2phy(Log_Addr log) { return Phy_Addr((RAM_BASE == PHY_MEM) ? log : (RAM_BASE > PHY_MEM) ? log + (RAM_BASE - PHY_MEM) : log - (PHY_MEM - RAM_BASE)); }
 #endif
 
-    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? ((phy >> PT_SHIFT) & 0x7f) % COLORS : WHITE); } // TODO: what is 0x7f
+    // The color of a frame is given by the LLC set index bits right above the page offset
+    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? (phy >> PT_SHIFT) & (COLORS - 1) : WHITE); }
 
     static Color log2color(Log_Addr log) {
         if(colorful) {
             Page_Directory * pd = current();
-            Page_Table * pt = pd->log()[pdi(log)];
-            Phy_Addr phy = pt->log()[pti(log)] | off(log);
-            return static_cast<Color>(((phy >> PT_SHIFT) & 0x7f) % COLORS);
+            Page_Table * pt = pde2phy(pd->log()[pdi(log)]);
+            return phy2color(pte2phy(pt->log()[pti(log)]));
         } else
             return WHITE;
     }
@@ -501,7 +550,8 @@ private:
     static void init();
 
 private:
-    static List _free[colorful * COLORS + 1]; // +1 for WHITE
+    static List _free[colorful * COLORS + 1]; // +1 for WHITE (unused if buddy)
+    static Buddy _buddy;
     static Page_Directory * _master;
 };
 
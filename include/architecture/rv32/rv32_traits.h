@@ -13,12 +13,21 @@ template<> struct Traits<CPU>: public Traits<Build>
     static const unsigned int WORD_SIZE         = 32;
     static const unsigned int CLOCK             = 50000000;
     static const bool unaligned_memory_access   = false;
+    static const unsigned int CACHE_LINE_SIZE   = 64;
 };
 
 template<> struct Traits<MMU>: public Traits<Build>
 {
-    static const bool colorful = false;
-    static const unsigned int COLORS = 1;
+    // Page coloring (Traits<System>::colorful) partitions the last-level cache by the physical address bits above the page
+    // offset that index its sets
+    static const unsigned int LLC_SIZE = 16 * 1024; // SiFive-E has no L2, so its D-cache is the LLC
+    static const unsigned int LLC_WAYS = 4;
+    static const unsigned int COLORS = LLC_SIZE / LLC_WAYS / 4096; // a power of 2, up to 32 (see Color)
+
+    // Buddy-system frame allocator (O(log n) alloc/free, power-of-two requests come naturally aligned)
+    static const bool buddy = true;
+    static const unsigned int ORDERS = 11; // blocks of up to 2^10 frames
+    static const bool huge_pages = false; // only SV39 maps huge pages
 };
 
 template<> struct Traits<FPU>: public Traits<Build>
@@ -35,6 +44,7 @@ template<> struct Traits<TSC>: public Traits<Build>
 template<> struct Traits<PMU>: public Traits<Build>
 {
     static const bool enabled = true;
+    static const unsigned int VIRTUAL_CHANNELS = 5; // cycle, time, instret, mhpmcounter3 and 4 (saved and restored for threads that enable PMU virtualization)
 };
 
 __END_SYS
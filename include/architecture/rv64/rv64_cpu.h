@@ -313,8 +313,30 @@ public:
     }
 
 
+    // Lock-free compare-and-swap (LR/SC), for data structures that cannot afford a lock word
+    template <typename T>
+    static T cas(volatile T & value, T compare, T replacement) {
+        register T old;
+        if(sizeof(T) == sizeof(Reg64))
+            ASM("1: lr.d    %0, (%1)        \n"
+                "   bne     %0, %2, 2f      \n"
+                "   sc.d    t3, %3, (%1)    \n"
+                "   bnez    t3, 1b          \n"
+                "2:                         \n" : "=&r"(old) : "r"(&value), "r"(compare), "r"(replacement) : "t3", "cc", "memory");
+        else
+            ASM("1: lr.w    %0, (%1)        \n"
+                "   bne     %0, %2, 2f      \n"
+                "   sc.w    t3, %3, (%1)    \n"
+                "   bnez    t3, 1b          \n"
+                "2:                         \n" : "=&r"(old) : "r"(&value), "r"(compare), "r"(replacement) : "t3", "cc", "memory");
+        return old;
+    }
+
     static void flush_tlb() {         ASM("sfence.vma"    : :           : "memory"); }
     static void flush_tlb(Reg addr) { ASM("sfence.vma %0" : : "r"(addr) : "memory"); }
+    static void flush_tlb_asid(Reg asid) { ASM("sfence.vma x0, %0" : : "r"(asid) : "memory"); } // but global mappings
+
+    using CPU_Common::fence;
 
     using CPU_Common::htole64;
     using CPU_Common::htole32;
@@ -459,6 +481,7 @@ public:
     static void sret() { ASM("sret"); }
 
     static void satp(Reg r) { ASM("csrw satp, %0" : : "r"(r) : "cc"); ASM("sfence.vma" : : : "memory"); }
+    static void satp(Reg r, bool flush) { ASM("csrw satp, %0" : : "r"(r) : "cc"); if(flush) ASM("sfence.vma" : : : "memory"); }
     static Reg  satp() { Reg r; ASM("csrr %0, satp" :  "=r"(r) : : ); return r; }
 
 private:
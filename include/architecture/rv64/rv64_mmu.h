@@ -7,6 +7,7 @@
 #include <architecture/mmu.h>
 #undef __mmu_common_only__
 #include <system/memory_map.h>
+#include <utility/buddy.h>
 
 __BEGIN_SYS
 
@@ -19,12 +20,23 @@ private:
     typedef Grouping_List<Frame> List;
     typedef MMU_Common<9, 9, 12, 9> Common;
 
-    static const bool colorful = Traits<MMU>::colorful;
+    static const bool colorful = Traits<System>::colorful;
+    static const bool huge_pages = Traits<MMU>::huge_pages;
     static const unsigned long COLORS = Traits<MMU>::COLORS;
+    static const bool buddy = Traits<MMU>::buddy; // for the WHITE frames, colored ones are still kept in lists
+    static const unsigned long FRAMES = (Memory_Map::RAM_TOP + 1 - Memory_Map::RAM_BASE) / PG_SIZE;
     static const unsigned long RAM_BASE = Memory_Map::RAM_BASE;
     static const unsigned long PHY_MEM = Memory_Map::PHY_MEM;
     static const unsigned long APP_LOW = Memory_Map::APP_LOW;
     static const unsigned long APP_HIGH = Memory_Map::APP_HIGH;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+
+    // SATP fields (the ASID field is 16 bits wide, but implementations may support fewer of them)
+    static const unsigned long PPN_MASK = (1UL << 44) - 1;
+    static const unsigned long ASID_SHIFT = 44;
+    static const unsigned long ASID_MASK = (1UL << 16) - 1;
+
+    typedef Buddy_Allocator<SV39_MMU, Memory_Map::RAM_BASE, buddy ? FRAMES : 1, PG_SIZE, Traits<MMU>::ORDERS> Buddy;
 
 public:
     // Page Flags
@@ -53,6 +65,7 @@ public:
             SYSD = (V | R | W     | IAD),
             IO   = (SYSD | MIO),
             DMA  = (SYSD | CT),
+            COW  = (CT | MIO), // Copy-on-write (a combination of the RSW bits no mapping of a single kind uses)
             MASK = (1 << 10) - 1,
 
             PT  = V,
@@ -109,9 +122,17 @@ public:
             if(addr)
                 remap(addr, from, to, flags);
             else
-                for( ; from < to; from++) {
-                    Log_Addr * pte = phy2log(&_entry[from]);
-                    *pte = phy2pte(alloc(1, color), flags);
+                while(from < to) {
+                    // Whole page tables are still mapped contiguously if possible, so attach() can use huge pages for them
+                    Phy_Addr block = (huge_pages && !(from % ENTRIES) && (to - from >= int(ENTRIES))) ? alloc(ENTRIES, color) : Phy_Addr(false);
+                    if(block) {
+                        remap(block, from, from + ENTRIES, flags);
+                        from += ENTRIES;
+                    } else {
+                        Log_Addr * pte = phy2log(&_entry[from]);
+                        *pte = phy2pte(alloc(1, color), flags);
+                        from++;
+                    }
                 }
         }
 
@@ -128,16 +149,44 @@ public:
             }
         }
 
+        // Pages are only given frames when first accessed (see fault())
+        void reserve(int from, int to, Page_Flags flags, Color color) {
+            for( ; from < to; from++) {
+                Log_Addr * pte = phy2log(&_entry[from]);
+                *pte = lazy(flags, color);
+            }
+        }
+
+        // Lazy pages stay lazy and shared frames stay copy-on-write
         void reflag(int from, int to, Page_Flags flags) {
             for( ; from < to; from++) {
                 Log_Addr * pte = phy2log(&_entry[from]);
-                *pte = phy2pte(pte2phy(_entry[from]), flags);
+                PT_Entry entry = _entry[from];
+                if(!(entry & Page_Flags::V))
+                    *pte = entry ? lazy(flags, pte2color(entry)) : PT_Entry(0);
+                else
+                    *pte = phy2pte(pte2phy(entry), shared(pte2phy(entry)) ? protect(flags) : flags);
+            }
+        }
+
+        // Maps the pages [from, to) of this table also in pt, starting at entry at, sharing their frames copy-on-write
+        void share(_Page_Table * pt, int at, int from, int to) {
+            for( ; from < to; from++, at++) {
+                Log_Addr * src = phy2log(&_entry[from]);
+                Log_Addr * dst = phy2log(&pt->_entry[at]);
+                PT_Entry entry = _entry[from];
+                if(entry & Page_Flags::V) {
+                    _shares[frame(pte2phy(entry))]++;
+                    entry = phy2pte(pte2phy(entry), protect(pte2flg(entry)));
+                    *src = entry;
+                }
+                *dst = entry; // lazy pages are not shared, each copy gets its own frame when touching them
             }
         }
 
         void unmap(int from, int to) {
             for( ; from < to; from++) {
-                free(_entry[from]);
+                release(_entry[from]);
                 Log_Addr * pte = phy2log(&_entry[from]);
                 *pte = 0;
             }
@@ -175,37 +224,61 @@ public:
     class Chunk
     {
     public:
-        Chunk(const Chunk & c): _free(false), _from(c._from), _to(c._to), _pts(c._pts), _flags(c._flags), _pt(c._pt) {} // avoid freeing memory when temporaries are created
+        Chunk(const Chunk & c): _free(false), _lazy(c._lazy), _from(c._from), _to(c._to), _pts(c._pts), _flags(c._flags), _pt(c._pt) {} // avoid freeing memory when temporaries are created
 
+        // With Flags::LZ, only the page tables are allocated and each page gets its frame on first access (see fault())
         Chunk(unsigned long bytes, Flags flags, Color color = WHITE)
-        : _free(true), _from(0), _to(pages(bytes)), _pts(Common::pts(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
+        : _free(true), _lazy((flags & Flags::LZ) && !(flags & Flags::CT)), _from(0), _to(pages(bytes)), _pts(Common::pts(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
             if(_flags & Page_Flags::CT)
                 _pt->map_contiguous(_from, _to, _flags, color);
+            else if(_lazy)
+                _pt->reserve(_from, _to, _flags, color);
             else
                 _pt->map(_from, _to, _flags, color);
         }
 
         Chunk(Phy_Addr phy_addr, unsigned long bytes, Flags flags)
-        : _free(true), _from(0), _to(pages(bytes)), _pts(Common::pts(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
+        : _free(true), _lazy(false), _from(0), _to(pages(bytes)), _pts(Common::pts(_to - _from)), _flags(Page_Flags(flags)), _pt(calloc(_pts, WHITE)) {
             _pt->remap(phy_addr, _from, _to, flags);
         }
 
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags)
-        : _free(false), _from(from), _to(to), _pts(Common::pts(_to - _from)), _flags(flags), _pt(pt) {}
+        : _free(false), _lazy(false), _from(from), _to(to), _pts(Common::pts(_to - _from)), _flags(flags), _pt(pt) {}
 
         Chunk(Phy_Addr pt, unsigned int from, unsigned int to, Flags flags, Phy_Addr phy_addr)
-        : _free(false), _from(from), _to(to), _pts(Common::pts(_to - _from)), _flags(flags), _pt(pt) {
+        : _free(false), _lazy(false), _from(from), _to(to), _pts(Common::pts(_to - _from)), _flags(flags), _pt(pt) {
             _pt->remap(phy_addr, _from, _to, flags);
         }
 
+        // A clone of source whose frames are shared copy-on-write (see fault()); contiguous chunks are copied eagerly,
+        // since their frames must stay contiguous, and I/O ones just alias the same device memory
+        // Source mappings of writable pages become read-only, so huge pages attached before cloning must be re-attached
+        Chunk(const Chunk * source)
+        : _free(true), _lazy(source->_lazy), _from(0), _to(source->_to - source->_from), _pts(Common::pts(_to - _from)), _flags(source->_flags), _pt(calloc(_pts, WHITE)) {
+            if(_flags & Page_Flags::IO)
+                _pt->remap(pte2phy((*source->_pt)[source->_from]), _from, _to, _flags);
+            else if(_flags & Page_Flags::CT) {
+                _pt->map_contiguous(_from, _to, _flags, phy2color(pte2phy((*source->_pt)[source->_from])));
+                memcpy(phy2log(pte2phy((*_pt)[_from])), phy2log(pte2phy((*source->_pt)[source->_from])), size());
+            } else {
+                bool disabled = lock();
+                source->_pt->share(_pt, _from, source->_from, source->_to);
+                flush_tlb();
+                unlock(disabled);
+            }
+        }
+
         ~Chunk() {
             if(_free) {
                 if(!(_flags & Page_Flags::IO)) {
                     if(_flags & Page_Flags::CT)
                         free((*_pt)[_from], _to - _from);
-                    else
+                    else {
+                        bool disabled = lock();
                         for( ; _from < _to; _from++)
-                            free((*_pt)[_from]);
+                            release((*_pt)[_from]);
+                        unlock(disabled);
+                    }
                 }
                 free(_pt, _pts);
             }
@@ -244,7 +317,10 @@ public:
                     _pts = pts;
                 }
 
-                _pt->map(_to, _to + pgs, _flags, color);
+                if(_lazy)
+                    _pt->reserve(_to, _to + pgs, _flags, color);
+                else
+                    _pt->map(_to, _to + pgs, _flags, color);
                 _to += pgs;
             } else
                 db<MMU>(WRN) << "MMU::Chunk::resize(amount=" << amount << "): segment shrinking not implemented!" << endl;
@@ -254,6 +330,7 @@ public:
 
     private:
         bool _free;
+        bool _lazy;
         unsigned int _from;
         unsigned int _to;
         unsigned int _pts;
@@ -265,21 +342,21 @@ public:
     class Directory
     {
     public:
-        Directory(const Directory & d): _free(false), _pd(d._pd) {} // avoid freeing memory when temporaries are created
+        Directory(const Directory & d): _free(false), _pd(d._pd), _asid(d._asid) {} // avoid freeing memory when temporaries are created
 
-        Directory(): _free(true), _pd(calloc(1, WHITE)) {
+        Directory(): _free(true), _pd(calloc(1, WHITE)), _asid(0) {
             for(unsigned int i = 0; i < PD_ENTRIES; i++)
                 if(!((i >= pdi(APP_LOW)) && (i <= pdi(APP_HIGH))))
                     _pd->log()[i] = _master->log()[i];
         }
 
-        Directory(Page_Directory * pd): _free(false), _pd(pd) {}
+        Directory(Page_Directory * pd): _free(false), _pd(pd), _asid(0) {} // wrappers have no ASID, so activating them flushes the TLB
 
         ~Directory() {
             if(_free) {
                 for(unsigned int i = pdi(APP_LOW); i < pdi(APP_HIGH); i++) {
                     Attacher * at = pde2phy(_pd->log()[i]);
-                    if(at)
+                    if(at && !leaf(_pd->log()[i]))
                         free(at);
                 }
                 free(_pd);
@@ -288,15 +365,24 @@ public:
 
         Phy_Addr pd() const { return _pd; }
 
-        void activate() const { SV39_MMU::pd(_pd); }
+        void activate() const {
+            if(_free)
+                _asid = asid(_asid);
+            SV39_MMU::pd(_pd, _asid);
+        }
 
         Log_Addr find(const Chunk & chunk) {
             for(unsigned int i = 0; i < PD_ENTRIES; i++) {
-                Attacher * at = pde2phy(_pd->log()[i]);
-                if(at)
+                PD_Entry pde = _pd->log()[i];
+                if(leaf(pde)) {
+                    if((chunk.pts() >= AT_ENTRIES) && maps(pde, chunk.pt(), AT_ENTRIES))
+                        return i << PD_SHIFT;
+                } else if(pde) {
+                    Attacher * at = pde2phy(pde);
                     for(unsigned int j = 0; j < AT_ENTRIES; j++)
-                        if(unflag(ate2phy(at->log()[j])) == unflag(chunk.pt()))
+                        if(maps(at->log()[j], chunk.pt(), 1))
                             return (i << PD_SHIFT) + (j << AT_SHIFT);
+                }
             }
             return Log_Addr(false);
         }
@@ -334,57 +420,76 @@ public:
                 db<MMU>(WRN) << "MMU::Directory::detach(chunk=" << &chunk << ",addr=" << addr << ") [pt=" << chunk.pt() << "] failed!" << endl;
         }
 
-        Phy_Addr physical(Log_Addr addr) {
-            Attacher * at = _pd->log()[pdi(addr)];
-            Page_Table * pt = at->log()[ati(addr)];
-            return pt->log()[pti(addr)] | off(addr);
-        };
+        Phy_Addr physical(Log_Addr addr) { return translate(_pd, addr); }
 
     private:
+        // The page tables of a chunk are split among the attachers they span: n of them go to attacher i from entry j on
         bool attachable(Log_Addr addr, const Page_Table * pt, unsigned int pts, Page_Flags flags) {
-            for(unsigned int i = pdi(addr); i < pdi(addr) + ats(pts); i++) {
-                Attacher * at = pde2phy(_pd->log()[i]);
-                if(!at)
-                    continue;
-                else
-                    for(unsigned int j = ati(addr); j < ati(addr) + pts; j++, pt++)
-                        if(at->log()[j & (AT_ENTRIES - 1)])
+            for(unsigned int i = pdi(addr), j = ati(addr); pts; i++, j = 0) {
+                unsigned int n = (pts < AT_ENTRIES - j) ? pts : AT_ENTRIES - j;
+                PD_Entry pde = _pd->log()[i];
+                if(leaf(pde))
+                    return false;
+                if(pde) {
+                    Attacher * at = pde2phy(pde);
+                    for(unsigned int k = 0; k < n; k++)
+                        if(at->log()[j + k])
                             return false;
+                }
+                pts -= n;
             }
             return true;
         }
 
         Log_Addr attach(Log_Addr addr, const Page_Table * pt, unsigned int pts, Page_Flags flags) {
-            for(unsigned int i = pdi(addr); i < pdi(addr) + ats(pts); i++) {
-                Attacher * at = pde2phy(_pd->log()[i]);
-                if(!at) {
-                    at = calloc(1, WHITE);
-                    _pd->log()[i] = phy2pde(Phy_Addr(at));
+            for(unsigned int i = pdi(addr), j = ati(addr); pts; i++, j = 0) {
+                unsigned int n = (pts < AT_ENTRIES - j) ? pts : AT_ENTRIES - j;
+                PD_Entry giga = (huge_pages && (n == AT_ENTRIES) && !_pd->log()[i]) ? huge(pt, AT_ENTRIES) : PD_Entry(0);
+                if(giga)
+                    _pd->log()[i] = giga;
+                else {
+                    Attacher * at = pde2phy(_pd->log()[i]);
+                    if(!at) {
+                        at = calloc(1, WHITE);
+                        _pd->log()[i] = phy2pde(Phy_Addr(at));
+                    }
+                    for(unsigned int k = 0; k < n; k++)
+                        at->log()[j + k] = ate(pt + k);
                 }
-                for(unsigned int j = ati(addr); j < ati(addr) + pts; j++, pt++)
-                    at->log()[j & (AT_ENTRIES - 1)] = phy2ate(Phy_Addr(pt));
+                pt += n;
+                pts -= n;
             }
             return addr;
         }
 
         Log_Addr detach(Log_Addr addr, const Page_Table * pt, unsigned int pts) {
-            for(unsigned int i = pdi(addr); i < pdi(addr) + ats(pts); i++) {
-                Attacher * at = pde2phy(_pd->log()[i]);
-                if(at) {
-                    for(unsigned int j = ati(addr); j < ati(addr) + pts; j++, pt++)
-                        if(unflag(ate2phy(at->log()[j & (AT_ENTRIES - 1)])) == unflag(pt))
-                            at->log()[j] = 0;
+            for(unsigned int i = pdi(addr), j = ati(addr); pts; i++, j = 0) {
+                unsigned int n = (pts < AT_ENTRIES - j) ? pts : AT_ENTRIES - j;
+                PD_Entry & pde = _pd->log()[i];
+                if(leaf(pde)) {
+                    if((n == AT_ENTRIES) && maps(pde, pt, AT_ENTRIES))
+                        pde = 0;
+                    else
+                        return Log_Addr(false);
+                } else if(pde) {
+                    Attacher * at = pde2phy(pde);
+                    for(unsigned int k = 0; k < n; k++)
+                        if(maps(at->log()[j + k], pt + k, 1))
+                            at->log()[j + k] = 0;
                         else
                             return Log_Addr(false);
                 }
+                pt += n;
+                pts -= n;
             }
-            flush_tlb();
+            flush_asid(_asid);
             return addr;
         }
 
     private:
         bool _free;
         Page_Directory * _pd;  // this is a physical address, but operator*() returns a logical address
+        mutable unsigned long _asid; // generation | ASID, renewed by activate() when its generation is gone
     };
 
     // DMA_Buffer
@@ -451,11 +556,16 @@ public:
         Phy_Addr phy(false);
 
         if(frames) {
-            List::Element * e = _free[color].search_decrementing(frames);
-            if(e) {
-                phy = e->object() + e->size();
+            if(buddy && (color == WHITE))
+                phy = _buddy.alloc(frames);
+            else {
+                List::Element * e = _free[color].search_decrementing(frames);
+                if(e)
+                    phy = e->object() + e->size();
+            }
+            if(phy)
                 db<MMU>(TRC) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => " << phy << endl;
-            } else
+            else
                 if(colorful)
                     db<MMU>(INF) << "MMU::alloc(frames=" << frames << ",color=" << color << ") => failed!" << endl;
                 else
@@ -478,7 +588,10 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << color << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy && (color == WHITE)) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[color].insert_merging(e, &m1, &m2);
@@ -491,22 +604,82 @@ public:
 
         db<MMU>(TRC) << "MMU::free(frame=" << frame << ",color=" << WHITE << ",n=" << n << ")" << endl;
 
-        if(frame && n) {
+        if(buddy) {
+            if(frame && n)
+                _buddy.free(frame, n);
+        } else if(frame && n) {
             List::Element * e = new (phy2log(frame)) List::Element(frame, n);
             List::Element * m1, * m2;
             _free[WHITE].insert_merging(e, &m1, &m2);
         }
     }
 
-    static unsigned long allocable(Color color = WHITE) { return _free[color].head() ? _free[color].head()->size() : 0; }
+    static unsigned long allocable(Color color = WHITE) {
+        if(buddy && (color == WHITE))
+            return _buddy.allocable();
+        return _free[color].head() ? _free[color].head()->size() : 0;
+    }
+
+    // Number of free blocks of 2^order frames in the buddy system (always 0 without it)
+    static unsigned long free_blocks(unsigned int order) { return buddy ? _buddy.blocks(order) : 0; }
+
+    // Number of free frames, in all colors (allocable() is only the largest block)
+    static unsigned long free_frames() {
+        unsigned long frames = buddy ? _buddy.size() : _free[WHITE].grouped_size();
+        for(unsigned int i = 1; i < colorful * COLORS + 1; i++)
+            frames += _free[i].grouped_size();
+        return frames;
+    }
 
     static Page_Directory * volatile current() { return static_cast<Page_Directory * volatile>(pd()); }
 
-    static Phy_Addr physical(Log_Addr addr) {
-        Page_Directory * pd = current();
-        Attacher * at = pd->log()[pdi(addr)];
-        Page_Table * pt = at->log()[ati(addr)];
-        return pt->log()[pti(addr)] | off(addr);
+    static Phy_Addr physical(Log_Addr addr) { return translate(current(), addr); }
+
+    // Page fault handler (called by the IC): gives lazy pages their zeroed frames and, on writes, copies shared
+    // copy-on-write frames (the last sharer just gets write permission back); returns false for actual faults
+    static bool fault(Log_Addr addr, bool write) {
+        bool handled = false;
+        bool disabled = lock();
+
+        PD_Entry pde = current()->log()[pdi(addr)];
+        if((pde & Page_Flags::V) && !leaf(pde)) {
+            Attacher * at = pde2phy(pde);
+            PT_Entry ate = at->log()[ati(addr)];
+            if((ate & Page_Flags::V) && !leaf(ate)) {
+                Page_Table * pt = ate2phy(ate);
+                PT_Entry & pte = pt->log()[pti(addr)];
+                if(!(pte & Page_Flags::V) && pte) {
+                    Phy_Addr frame = alloc(1, pte2color(pte));
+                    if(frame) {
+                        memset(phy2log(frame), 0, sizeof(Page));
+                        pte = phy2pte(frame, pte2flg(pte) | Page_Flags::V);
+                        handled = true;
+                    }
+                } else if(write && cow(pte)) {
+                    Phy_Addr frame = pte2phy(pte);
+                    if(shared(frame)) {
+                        Phy_Addr copy = alloc(1, phy2color(frame));
+                        if(copy) {
+                            memcpy(phy2log(copy), phy2log(frame), sizeof(Page));
+                            _shares[SV39_MMU::frame(frame)]--;
+                        }
+                        frame = copy;
+                    }
+                    if(frame) {
+                        pte = phy2pte(frame, (pte2flg(pte) & ~Page_Flags::COW) | Page_Flags::W);
+                        handled = true;
+                    }
+                }
+            }
+        }
+
+        if(handled)
+            flush_tlb(addr);
+        unlock(disabled);
+
+        db<MMU>(TRC) << "MMU::fault(addr=" << addr << ",write=" << write << ") => " << handled << endl;
+
+        return handled;
     }
 
     static PT_Entry   phy2pte(Phy_Addr frame, Page_Flags flags) { return (frame >> 2) | flags; }
@@ -528,33 +701,190 @@ public:
     static Phy_Addr log2phy(Log_Addr log) { return Phy_Addr((RAM_BASE == PHY_MEM) ? log : (RAM_BASE > PHY_MEM) ? log + (RAM_BASE - PHY_MEM) : log - (PHY_MEM - RAM_BASE)); }
 #endif
 
-    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? ((phy >> PT_SHIFT) & 0x7f) % COLORS : WHITE); } // TODO: what is 0x7f
+    // The color of a frame is given by the LLC set index bits right above the page offset
+    static Color phy2color(Phy_Addr phy) { return static_cast<Color>(colorful ? (phy >> PT_SHIFT) & (COLORS - 1) : WHITE); }
 
     static Color log2color(Log_Addr log) {
         if(colorful) {
             Page_Directory * pd = current();
-            Page_Table * pt = pd->log()[pdi(log)];
-            Phy_Addr phy = pt->log()[pti(log)] | off(log);
-            return static_cast<Color>(((phy >> PT_SHIFT) & 0x7f) % COLORS);
+            Attacher * at = pde2phy(pd->log()[pdi(log)]);
+            Page_Table * pt = ate2phy(at->log()[ati(log)]);
+            return phy2color(pte2phy(pt->log()[pti(log)]));
         } else
             return WHITE;
     }
 
 private:
-    static Phy_Addr pd() { return CPU::satp() << PT_SHIFT; }
+    // Entries with any of R, W or X set are leaves, i.e. huge pages if found above the last level
+    static bool leaf(PT_Entry entry) { return entry & (Page_Flags::R | Page_Flags::W | Page_Flags::X); }
+
+    // The leaf entry that maps all frames of the n page tables starting at pt with a single huge page (2 MB for n = 1,
+    // 1 GB for n = AT_ENTRIES), or 0 if they are not physically contiguous, aligned to the huge page and equally flagged
+    static PT_Entry huge(const Page_Table * pt, unsigned int n) {
+        Page_Table * t = const_cast<Page_Table *>(pt);
+        PT_Entry first = t->log()[0];
+        Phy_Addr base = pte2phy(first);
+        Page_Flags flags = pte2flg(first);
+        if(!(flags & Page_Flags::V) || cow(first) || (base & (n * PT_SPAN - 1)))
+            return 0;
+        for(unsigned int k = 0; k < n; k++, t++)
+            for(unsigned int i = 0; i < PT_ENTRIES; i++)
+                if(t->log()[i] != phy2pte(base + (k * PT_ENTRIES + i) * sizeof(Page), flags))
+                    return 0;
+        return phy2pte(base, flags);
+    }
+
+    // What goes in an attacher for a page table: a 2 MB leaf when possible, a pointer to the table otherwise
+    static PT_Entry ate(const Page_Table * pt) {
+        PT_Entry mega = huge_pages ? huge(pt, 1) : PT_Entry(0);
+        return mega ? mega : phy2ate(Phy_Addr(pt));
+    }
+
+    // Whether an entry of an attacher (n = 1) or of the directory (n = AT_ENTRIES) maps the page tables starting at pt,
+    // either pointing to the table or as a huge page over its frames. Only addresses are compared, for reflag() and lazy
+    // faults change the flags and contiguity ate() and huge() would find now for a table attached before.
+    static bool maps(PT_Entry entry, const Page_Table * pt, unsigned int n) {
+        if(!(entry & Page_Flags::V))
+            return false;
+        if(!leaf(entry))
+            return (n == 1) && (ate2phy(entry) == Phy_Addr(pt));
+        PT_Entry first = const_cast<Page_Table *>(pt)->log()[0];
+        return (first & Page_Flags::V) && (pte2phy(entry) == pte2phy(first));
+    }
+
+    // Lazy pages have invalid entries (ignored by the hardware) that keep the flags and color to map them with
+    static PT_Entry lazy(Page_Flags flags, Color color) { return phy2pte(Phy_Addr(static_cast<unsigned long>(color) << PT_SHIFT), flags & ~Page_Flags::V); }
+    static Color pte2color(PT_Entry entry) { return static_cast<Color>(pte2phy(entry) >> PT_SHIFT); }
+
+    // Shared frames are mapped read-only, with writable pages marked copy-on-write
+    static bool cow(PT_Entry entry) { return (entry & Page_Flags::COW) == Page_Flags::COW; }
+    static Page_Flags protect(Page_Flags flags) { return (flags & Page_Flags::W) ? Page_Flags((flags & ~Page_Flags::W) | Page_Flags::COW) : flags; }
+
+    static unsigned long frame(Phy_Addr phy) { return (phy - RAM_BASE) >> PT_SHIFT; }
+    static bool shared(Phy_Addr phy) { return (phy >= RAM_BASE) && (frame(phy) < FRAMES) && _shares[frame(phy)]; }
+
+    // Frees the frame of a page, unless other chunks still share it
+    static void release(PT_Entry entry) {
+        if(!(entry & Page_Flags::V))
+            return;
+        Phy_Addr phy = pte2phy(entry);
+        if(shared(phy))
+            _shares[frame(phy)]--;
+        else
+            free(phy);
+    }
+
+    // Serializes fault() with cloning and releasing, also against faults on the same CPU (hence disabling interrupts)
+    static bool lock() {
+        bool disabled = CPU::int_disabled();
+        CPU::int_disable();
+        while(CPU::tsl(_lock));
+        return disabled;
+    }
+
+    static void unlock(bool disabled) {
+        _lock = false;
+        if(!disabled)
+            CPU::int_enable();
+    }
+
+    static Phy_Addr translate(Page_Directory * pd, Log_Addr addr) {
+        PD_Entry pde = pd->log()[pdi(addr)];
+        if(leaf(pde))
+            return pde2phy(pde) + (addr & (AT_SPAN - 1));
+        Attacher * at = pde2phy(pde);
+        PT_Entry entry = at->log()[ati(addr)];
+        if(leaf(entry))
+            return ate2phy(entry) + (addr & (PT_SPAN - 1));
+        Page_Table * pt = ate2phy(entry);
+        return pte2phy(pt->log()[pti(addr)]) | off(addr);
+    }
+
+    static Phy_Addr pd() { return (CPU::satp() & PPN_MASK) << PT_SHIFT; }
     static void pd(Phy_Addr pd) { CPU::satp((1UL << 63) | (pd >> PT_SHIFT)); }
 
+    // The TLB is only flushed when switching to a directory without an ASID (i.e. ASID 0), since entries are tagged
+    static void pd(Phy_Addr pd, unsigned long asid) {
+        asid &= ASID_MASK;
+        CPU::satp((1UL << 63) | (asid << ASID_SHIFT) | (pd >> PT_SHIFT), !asid);
+    }
+
+    // ASIDs are handed out in generations: a Directory keeps its ASID while it belongs to the current generation and,
+    // when ASIDs run out, a new generation begins, all TLBs are flushed (each CPU on its next switch) and Directories get
+    // new ASIDs as they are activated again. ASID 0 is never handed out.
+    static unsigned long asid(unsigned long current) {
+        if(asids() <= 1)
+            return 0;
+        if(((current & ~ASID_MASK) == _asid_generation) && !_asid_flush[CPU::id()])
+            return current;
+
+        bool disabled = lock();
+        if((current & ~ASID_MASK) != _asid_generation) {
+            if(_next_asid >= asids()) {
+                _asid_generation += ASID_MASK + 1;
+                _next_asid = 1;
+                for(unsigned int i = 0; i < CPUS; i++)
+                    _asid_flush[i] = true;
+            }
+            current = _asid_generation | _next_asid++;
+        }
+        if(_asid_flush[CPU::id()]) {
+            _asid_flush[CPU::id()] = false;
+            flush_tlb();
+        }
+        unlock(disabled);
+
+        db<MMU>(TRC) << "MMU::asid() => " << (current & ASID_MASK) << " (generation " << current / (ASID_MASK + 1) << ")" << endl;
+
+        return current;
+    }
+
+    // The number of ASIDs the hardware implements, found by writing all ones to the field and reading it back
+    static unsigned long asids() {
+        if(!_asids) {
+            CPU::Reg satp = CPU::satp();
+            CPU::satp(satp | (ASID_MASK << ASID_SHIFT), false);
+            _asids = ((CPU::satp() >> ASID_SHIFT) & ASID_MASK) + 1;
+            CPU::satp(satp, true);
+        }
+        return _asids;
+    }
+
+    // Only the TLB of the calling hart is flushed: there is no remote shootdown, so SV39 address spaces must not be
+    // shared by threads running on other harts while chunks are detached from them (i.e. paging is single-core only)
+    static void flush_asid(unsigned long asid) {
+        if(asid & ASID_MASK)
+            CPU::flush_tlb_asid(asid & ASID_MASK);
+        else
+            flush_tlb();
+    }
+
     static void flush_tlb() { CPU::flush_tlb(); }
     static void flush_tlb(Log_Addr addr) { CPU::flush_tlb(addr); }
 
     static void init();
 
 private:
-    static List _free[colorful * COLORS + 1]; // +1 for WHITE
+    static List _free[colorful * COLORS + 1]; // +1 for WHITE (unused if buddy)
+    static Buddy _buddy;
     static Page_Directory * _master;
+    static unsigned int _shares[FRAMES]; // number of chunks sharing each frame besides its first owner (2^32 of them would take 32 GB of page tables)
+    static volatile bool _lock;
+    static unsigned long _asids;
+    static unsigned long _asid_generation; // starts at ASID_MASK + 1, so Directories without an ASID are always stale
+    static unsigned long _next_asid;
+    static volatile bool _asid_flush[CPUS];
 };
 
+// SETUP builds only a flat memory model on the RISC-V machines, so SV39_MMU is just what SETUP uses to build it and the
+// system's MMU is No_MMU. Defining __sv39__ makes SV39_MMU the system's MMU, which takes a SETUP that builds the system's
+// address space and an SV39_MMU::init(), neither of which exists yet.
+#ifdef __sv39__
+static_assert(Traits<Build>::CPUS == 1, "SV39 paging is single-core only, since TLB entries are never shot down on other harts");
+class MMU: public SV39_MMU {};
+#else
 class MMU: public No_MMU {};
+#endif
 
 __END_SYS
 
@@ -14,12 +14,24 @@ template<> struct Traits<CPU>: public Traits<Build>
     static const unsigned int WORD_SIZE         = 64;
     static const unsigned long CLOCK            = (MODEL == SiFive_U) ? 1000000000L : 50000000;
     static const bool unaligned_memory_access   = false;
+    static const unsigned int CACHE_LINE_SIZE   = 64;
 };
 
 template<> struct Traits<MMU>: public Traits<Build>
 {
-    static const bool colorful = false;
-    static const unsigned int COLORS = 1;
+    // Page coloring (Traits<System>::colorful) partitions the last-level cache by the physical address bits above the page
+    // offset that index its sets
+    static const unsigned int LLC_SIZE = 2 * 1024 * 1024; // SiFive-U L2
+    static const unsigned int LLC_WAYS = 16;
+    static const unsigned int COLORS = LLC_SIZE / LLC_WAYS / 4096; // a power of 2, up to 32 (see Color)
+
+    // Buddy-system frame allocator (O(log n) alloc/free, power-of-two requests come naturally aligned)
+    static const bool buddy = true;
+    static const unsigned int ORDERS = 11; // blocks of up to 2^10 frames
+
+    // Attached chunks get 2 MB (or 1 GB) leaf entries for each whole, aligned and physically contiguous page table (or
+    // attacher) they span, falling back to 4 KB pages at the edges. Reflagging an attached chunk requires re-attaching it.
+    static const bool huge_pages = true;
 };
 
 template<> struct Traits<FPU>: public Traits<Build>
@@ -36,6 +48,7 @@ template<> struct Traits<TSC>: public Traits<Build>
 template<> struct Traits<PMU>: public Traits<Build>
 {
     static const bool enabled = true;
+    static const unsigned int VIRTUAL_CHANNELS = 5; // cycle, time, instret, mhpmcounter3 and 4 (saved and restored for threads that enable PMU virtualization)
 };
 
 __END_SYS
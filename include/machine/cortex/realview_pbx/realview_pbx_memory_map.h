@@ -49,6 +49,7 @@ struct Memory_Map: public Cortex_Memory_Map
         APP_HIGH                = Traits<Machine>::APP_HIGH,
         APP_CODE                = Traits<Machine>::APP_CODE,
         APP_DATA                = Traits<Machine>::APP_DATA,
+        SCRATCHPAD              = NOT_USED,
 
         SYS_CODE                = NOT_USED,
         SYS_INFO                = NOT_USED,
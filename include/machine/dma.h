@@ -0,0 +1,183 @@
+// EPOS DMA Buffer Pool and Scatter-Gather Descriptor Declarations
+
+#ifndef __dma_h
+#define __dma_h
+
+#include <architecture.h>
+
+__BEGIN_SYS
+
+// Scatter-Gather Descriptor
+// Lists up to ENTRIES memory regions (with both the physical address a device needs and the logical one software
+// needs) that together hold a single transfer. It is trivially copyable and default-constructible, so it can be the Data
+// of a Buffer<Owner, Data> (utility/buffer.h), which then carries a transfer across a stack without copying its payload.
+template<unsigned int ENTRIES>
+class DMA_Descriptor
+{
+public:
+    typedef CPU::Phy_Addr Phy_Addr;
+    typedef CPU::Log_Addr Log_Addr;
+
+    struct Entry {
+        Phy_Addr phy;
+        Log_Addr log;
+        unsigned long size;
+    };
+
+public:
+    DMA_Descriptor(): _count(0), _size(0) {}
+
+    bool add(Phy_Addr phy, Log_Addr log, unsigned long size) {
+        if(_count == ENTRIES)
+            return false;
+        _entry[_count].phy = phy;
+        _entry[_count].log = log;
+        _entry[_count].size = size;
+        _count++;
+        _size += size;
+        return true;
+    }
+
+    void clear() { _count = 0; _size = 0; }
+
+    unsigned int count() const { return _count; }
+    unsigned long size() const { return _size; }
+    const Entry & operator[](unsigned int i) const { return _entry[i]; }
+
+    // Gathers (copies) up to max bytes of the described regions into buf and returns how many were copied, for devices
+    // (or software paths) that cannot scatter-gather
+    unsigned long gather(void * buf, unsigned long max) const {
+        unsigned long n = 0;
+        for(unsigned int i = 0; (i < _count) && (n < max); i++) {
+            unsigned long s = (_entry[i].size < max - n) ? _entry[i].size : max - n;
+            memcpy(reinterpret_cast<char *>(buf) + n, _entry[i].log, s);
+            n += s;
+        }
+        return n;
+    }
+
+    friend OStream & operator<<(OStream & os, const DMA_Descriptor & d) {
+        os << "{n=" << d._count << ",sz=" << d._size;
+        for(unsigned int i = 0; i < d._count; i++)
+            os << ",[" << d._entry[i].phy << "," << d._entry[i].size << "]";
+        os << "}";
+        return os;
+    }
+
+private:
+    unsigned int _count;
+    unsigned long _size;
+    Entry _entry[ENTRIES];
+};
+
+
+// DMA Buffer Pool
+// A single, physically contiguous MMU::DMA_Buffer allocated up front and carved into SLABS slabs of at least SLAB_SIZE
+// bytes, rounded up to whole cache lines so no two slabs share one. Drivers take slabs for each transfer and give
+// them back afterwards, instead of allocating (and mapping) a DMA_Buffer per transfer. Free slabs are kept in a
+// lock-free stack whose head carries a generation tag (against ABA), so alloc() and free() can be called concurrently
+// from any CPU, and also from interrupt handlers.
+template<unsigned int SLAB_SIZE, unsigned int SLABS>
+class DMA_Pool
+{
+private:
+    typedef CPU::Phy_Addr Phy_Addr;
+    typedef CPU::Log_Addr Log_Addr;
+    typedef MMU::DMA_Buffer DMA_Buffer;
+
+    static const unsigned int LINE = Traits<CPU>::CACHE_LINE_SIZE;
+    static const unsigned int INDEX_BITS = sizeof(unsigned long) * 4; // the other half of the head is the tag
+    static const unsigned long INDEX_MASK = (1UL << INDEX_BITS) - 1;
+
+public:
+    static const unsigned int SLAB = (SLAB_SIZE + LINE - 1) / LINE * LINE;
+
+public:
+    DMA_Pool(): _buffer(new (SYSTEM) DMA_Buffer(SLAB * SLABS)), _head(0), _free(0) {
+        static_assert(SLABS < INDEX_MASK, "DMA_Pool has too many slabs!");
+
+        _log = _buffer->log_address();
+        _phy = _buffer->phy_address();
+        for(unsigned int i = SLABS; i > 0; i--)
+            free(_log + (i - 1) * SLAB);
+
+        db<MMU>(TRC) << "DMA_Pool(slab=" << SLAB << ",slabs=" << SLABS << ") => {buf=" << *_buffer << "}" << endl;
+    }
+
+    ~DMA_Pool() {
+        if(_free != SLABS)
+            db<MMU>(WRN) << "~DMA_Pool(this=" << this << ") called with " << SLABS - _free << " slabs in use!" << endl;
+        delete _buffer;
+    }
+
+    // A free slab (its logical address), or 0 if all are in use
+    Log_Addr alloc() {
+        for(;;) {
+            unsigned long head = _head;
+            unsigned long i = head & INDEX_MASK;
+            if(!i)
+                return 0;
+            unsigned long next = _next[i - 1];
+            if(CPU::cas(_head, head, tag(head) | next) == head) {
+                CPU::fdec(_free);
+                return _log + (i - 1) * SLAB;
+            }
+        }
+    }
+
+    void free(Log_Addr slab) {
+        unsigned long i = (slab - _log) / SLAB;
+        for(;;) {
+            unsigned long head = _head;
+            _next[i] = head & INDEX_MASK;
+            CPU::fence(); // the link must be visible before the slab is
+            if(CPU::cas(_head, head, tag(head) | (i + 1)) == head)
+                break;
+        }
+        CPU::finc(_free);
+    }
+
+    // Takes as many slabs as needed to hold bytes (all or nothing) and lists them in d
+    template<unsigned int ENTRIES>
+    bool alloc(DMA_Descriptor<ENTRIES> * d, unsigned long bytes) {
+        d->clear();
+        while(bytes) {
+            Log_Addr slab = (d->count() < ENTRIES) ? alloc() : Log_Addr(0);
+            if(!slab) {
+                free(d);
+                return false;
+            }
+            unsigned long size = (bytes < SLAB) ? bytes : SLAB;
+            d->add(physical(slab), slab, size);
+            bytes -= size;
+        }
+        return true;
+    }
+
+    template<unsigned int ENTRIES>
+    void free(DMA_Descriptor<ENTRIES> * d) {
+        for(unsigned int i = 0; i < d->count(); i++)
+            free((*d)[i].log);
+        d->clear();
+    }
+
+    Phy_Addr physical(Log_Addr slab) const { return _phy + (slab - _log); }
+
+    unsigned int available() const { return _free; }
+
+private:
+    // Each successful update of the head bumps its tag, so a stale head never matches
+    static unsigned long tag(unsigned long head) { return (head & ~INDEX_MASK) + (1UL << INDEX_BITS); }
+
+private:
+    DMA_Buffer * _buffer;
+    Log_Addr _log;
+    Phy_Addr _phy;
+    volatile unsigned long _head; // tag | index + 1 of the first free slab (0 if none)
+    volatile unsigned long _next[SLABS];
+    volatile unsigned int _free;
+};
+
+__END_SYS
+
+#endif
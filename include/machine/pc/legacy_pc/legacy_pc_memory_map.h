@@ -30,6 +30,7 @@ struct Memory_Map
         APP_HIGH        = Traits<Machine>::APP_HIGH,
         APP_CODE        = Traits<Machine>::APP_CODE,
         APP_DATA        = Traits<Machine>::APP_DATA,
+        SCRATCHPAD      = NOT_USED, // the scratchpad is only reachable through a Segment, so __SCRATCHPAD_DATA stays in RAM
 
         INIT            = Traits<Machine>::INIT,
 
@@ -282,6 +282,7 @@ private:
     static void syscall(Interrupt_Id i);
     static void int_not(Interrupt_Id i);
     static void exception(Interrupt_Id i);
+    static void page_fault(Interrupt_Id i);
 
     // Physical handler
     static void entry() __attribute((naked, aligned(4)));
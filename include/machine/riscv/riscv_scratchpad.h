@@ -0,0 +1,29 @@
+// EPOS RISC-V Scratchpad Memory Mediator Declarations
+
+#ifndef __riscv_scratchpad_h
+#define __riscv_scratchpad_h
+
+#define __scratchpad_common_only__
+#include <machine/scratchpad.h>
+#undef __scratchpad_common_only__
+
+__BEGIN_SYS
+
+class Scratchpad: public Scratchpad_Base
+{
+    friend class Machine;
+
+private:
+    static const unsigned long ADDRESS = Traits<Scratchpad>::ADDRESS;
+    static const unsigned int SIZE = Traits<Scratchpad>::SIZE;
+
+public:
+    Scratchpad() {}
+
+private:
+    static void init();
+};
+
+__END_SYS
+
+#endif
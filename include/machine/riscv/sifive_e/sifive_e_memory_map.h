@@ -50,6 +50,7 @@ public:
         APP_HIGH        = Traits<Machine>::APP_HIGH,
         APP_CODE        = Traits<Machine>::APP_CODE,
         APP_DATA        = Traits<Machine>::APP_DATA,
+        SCRATCHPAD      = NOT_USED,
 
         PHY_MEM         = Traits<Machine>::PHY_MEM,
 
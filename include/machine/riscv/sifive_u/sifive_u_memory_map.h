@@ -52,6 +52,7 @@ public:
         APP_HIGH        = Traits<Machine>::APP_HIGH,
         APP_CODE        = Traits<Machine>::APP_CODE,
         APP_DATA        = Traits<Machine>::APP_DATA,
+        SCRATCHPAD      = Traits<Scratchpad>::enabled ? Traits<Scratchpad>::ADDRESS : NOT_USED, // __SCRATCHPAD_DATA is linked here (the flat memory model maps it 1:1)
 
         PHY_MEM         = Traits<Machine>::PHY_MEM,
 
@@ -151,7 +151,9 @@ template<> struct Traits<Serial_Display>: public Traits<Machine_Common>
 
 template<> struct Traits<Scratchpad>: public Traits<Machine_Common>
 {
-    static const bool enabled = false;
+    static const bool enabled = true; // also turns multiheap on wherever an application ties it to the scratchpad, so new (SCRATCHPAD) blocks know their heap
+    static const unsigned long ADDRESS = 0x08000000; // L2 Loosely-Integrated Memory (the L2 ways not yet enabled as cache)
+    static const unsigned int SIZE = 1024 * 1024;
 };
 
 __END_SYS
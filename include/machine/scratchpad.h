@@ -5,6 +5,7 @@
 
 #include <utility/heap.h>
 #include <memory.h>
+#include <system.h>
 
 __BEGIN_SYS
 
@@ -18,7 +19,12 @@ protected:
     Scratchpad_Base() {}
 
 public:
-    static void * alloc(unsigned int bytes) { return _heap->alloc(bytes); }
+    // Machines without scratchpad memory (or whose scratchpad has no block large enough left) serve requests from the
+    // system's heap instead
+    static void * alloc(unsigned int bytes) {
+        void * tmp = _heap ? _heap->alloc(bytes, false) : 0;
+        return tmp ? tmp : ::operator new(bytes, SYSTEM);
+    }
 
 protected:
     static Segment * _segment;
@@ -29,15 +35,17 @@ __END_SYS
 
 #endif
 
-#if defined(__SCRATCHPAD_H) && !defined(__scratchpad_common_only__)
+#if !defined(__scratchpad_common_only__)
+#ifdef __SCRATCHPAD_H
 #include __SCRATCHPAD_H
+#endif
 
 inline void * operator new(size_t bytes, const EPOS::Scratchpad_Allocator & allocator) {
-    return _SYS::Scratchpad::_heap->alloc(bytes);
+    return _SYS::Scratchpad_Base::alloc(bytes);
 }
 
 inline void * operator new[](size_t bytes, const EPOS::Scratchpad_Allocator & allocator) {
-    return _SYS::Scratchpad::_heap->alloc(bytes);
+    return _SYS::Scratchpad_Base::alloc(bytes);
 }
 
 #endif
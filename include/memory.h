@@ -20,6 +20,8 @@ public:
 
     using MMU::Directory::pd;
 
+    void activate();
+
     Log_Addr attach(Segment * seg);
     Log_Addr attach(Segment * seg, Log_Addr addr);
     void detach(Segment * seg);
@@ -40,14 +42,27 @@ public:
     typedef MMU::Flags Flags;
 
 public:
-    Segment(unsigned long bytes, Flags flags = Flags::APPD);
+    Segment(unsigned long bytes, Flags flags = Flags::APPD, Color color = WHITE);
     Segment(Phy_Addr phy_addr, unsigned long bytes, Flags flags);
+    Segment(const Segment * source); // copy-on-write clone (an eager copy if the MMU does not handle page faults)
     ~Segment();
 
     unsigned long size() const;
     Phy_Addr phy_address() const;
     long resize(long amount);
     void reflag(Flags flags);
+
+    // Cache partitioning policy (with Traits<System>::colorful)
+    // WHITE frames are shared by everyone, while the remaining colors are split evenly among the CPUs, which are also the
+    // partitions of partitioned schedulers, so a partition only evicts LLC lines of its own colors. Successive calls
+    // rotate over the colors of the partition.
+    static Color color(unsigned int partition);
+
+private:
+    static const unsigned int COLORS = Traits<System>::colorful ? Traits<MMU>::COLORS : 1;
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+
+    static volatile unsigned int _next_color[CPUS];
 };
 
 __END_SYS
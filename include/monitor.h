@@ -0,0 +1,138 @@
+// EPOS Monitor Component Declarations
+
+#ifndef __monitor_h
+#define __monitor_h
+
+#include <architecture/pmu.h>
+#include <architecture/tsc.h>
+#include <process.h>
+
+__BEGIN_SYS
+
+// Clerks are uniform readers for the events a Monitor can sample. They
+// are cheap to build and keep no state besides what identifies the event.
+
+// Performance counters
+// Counters are per-core, so setup() must be called on every CPU that is going to be sampled
+template<>
+class Clerk<PMU>
+{
+public:
+    typedef PMU_Event Event;
+    typedef PMU::Channel Channel;
+    typedef PMU::Count Data;
+
+public:
+    Clerk(const Event & event, const Channel & channel): _event(event), _channel(channel) {}
+
+    void setup() { PMU::config(_channel, _event); PMU::reset(_channel); }
+
+    Data read() const { return PMU::read(_channel); }
+    void reset() { PMU::reset(_channel); }
+
+    const Event & event() const { return _event; }
+    const Channel & channel() const { return _channel; }
+
+private:
+    Event _event;
+    Channel _channel;
+};
+
+// System events (scheduler statistics and time)
+// Times are in us; thread related events refer to the thread the Monitor preempted on the calling CPU
+template<>
+class Clerk<System>
+{
+public:
+    typedef System_Event Event;
+    typedef unsigned long long Data;
+
+public:
+    Clerk(const Event & event): _event(event) {}
+
+    Data read() const;
+
+    const Event & event() const { return _event; }
+
+private:
+    Event _event;
+};
+
+
+// Monitor
+// One thread per CPU periodically samples the Clerks listed at Traits<Monitor> into a per-core ring buffer.
+// The sampling cost is measured with the TSC and samples are skipped whenever a CPU exceeds Traits<Monitor>::OVERHEAD.
+class Monitor
+{
+    friend class System;                // for init()
+    friend class Thread;                // for dispatched()
+    friend class Clerk<System>;         // for _preempted and _busy
+
+private:
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const unsigned int THREADS = CPUS; // one sampler per CPU
+    static const unsigned int FREQUENCY = Traits<Monitor>::FREQUENCY;
+    static const unsigned int OVERHEAD = Traits<Monitor>::OVERHEAD;
+
+    typedef TSC::Time_Stamp Time_Stamp;
+
+public:
+    static const bool enabled = Traits<Monitor>::enabled;
+    static const unsigned int SYSTEM_EVENTS = sizeof(Traits<Monitor>::SYSTEM_EVENTS) / sizeof(System_Event);
+    static const unsigned int PMU_EVENTS = sizeof(Traits<Monitor>::PMU_EVENTS) / sizeof(PMU_Event);
+    static const unsigned int EVENTS = SYSTEM_EVENTS + PMU_EVENTS;
+    static const unsigned int SAMPLES = Traits<Monitor>::SAMPLES;
+
+    typedef unsigned long long Data;
+
+    // A sample holds the readings of the system Clerks followed by those of the PMU Clerks, in Traits<Monitor> order
+    struct Sample {
+        Time_Stamp time_stamp;
+        Data data[EVENTS];
+    };
+
+public:
+    Monitor() {}
+
+    static unsigned int samples(unsigned int cpu) { return (_head[cpu] < SAMPLES) ? _head[cpu] : SAMPLES; }
+    static unsigned long skipped(unsigned int cpu) { return _skipped[cpu]; }
+
+    // i = 0 is the oldest sample still in the buffer
+    static const Sample & sample(unsigned int cpu, unsigned int i) {
+        assert(i < samples(cpu));
+        return _buffer[cpu][(_head[cpu] - samples(cpu) + i) % SAMPLES];
+    }
+
+    static void dump(OStream & os);
+
+private:
+    static void sample();
+
+    static void dispatched(Thread * prev, Thread * next) {
+        unsigned int cpu = CPU::id();
+        Time_Stamp now = TSC::time_stamp();
+
+        if(prev->priority() != Thread::IDLE)
+            _busy[cpu] += now - _last_dispatch[cpu];
+        _last_dispatch[cpu] = now;
+        _preempted[cpu] = prev;
+    }
+
+    static int run();
+
+    static void init();
+
+private:
+    static Sample * _buffer[CPUS];
+    static volatile unsigned long _head[CPUS];
+    static volatile unsigned long _skipped[CPUS];
+    static Time_Stamp _cost[CPUS];
+    static Time_Stamp _start[CPUS];
+    static Time_Stamp _busy[CPUS];
+    static Time_Stamp _last_dispatch[CPUS];
+    static Thread * volatile _preempted[CPUS];
+};
+
+__END_SYS
+
+#endif
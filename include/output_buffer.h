@@ -0,0 +1,75 @@
+// EPOS Output Buffer Component Declarations
+
+#ifndef __output_buffer_h
+#define __output_buffer_h
+
+#include <architecture/cpu.h>
+
+__BEGIN_SYS
+
+// Output Buffer
+// When Traits<OStream>::buffered, kout and kerr format into a line buffer private to the CPU that is printing and only
+// complete lines are committed into that CPU's ring, so lines from different cores never interleave and no core busy-waits
+// on the Display. A low-priority daemon thread drains the rings into the Display whenever the system is otherwise idle.
+// Errors (i.e. panics) and shutdown synchronize(), flushing everything still buffered and reverting to synchronous output.
+class Output_Buffer
+{
+    friend class System;                // for init()
+
+private:
+    static const unsigned int CPUS = Traits<Build>::CPUS;
+    static const unsigned int SIZE = Traits<OStream>::buffered ? Traits<OStream>::BUFFER_SIZE : 1;
+    static const unsigned int LINE = Traits<OStream>::buffered ? 128 : 1; // longer lines are split
+    static const unsigned int PERIOD = 10000; // us between drainings when all rings are empty
+    static const unsigned int TRIES = 1000000; // spins on a lock before its holder is given up as gone
+
+    // Rings are zero-initialized POD (no constructors), since the system scaffold might be reconstructed on every CPU
+    struct Ring {
+        volatile bool lock;
+        unsigned int line_size;
+        char line[LINE];
+        volatile unsigned int head;     // next byte to be committed (producer)
+        volatile unsigned int tail;     // next byte to be drained (consumer)
+        char data[SIZE];
+    };
+
+public:
+    static const bool buffered = Traits<OStream>::buffered && Traits<Thread>::enabled; // draining needs a thread
+
+public:
+    static bool enabled() { return buffered && !_synchronous; }
+
+    static void put(const char * s);
+
+    // Flushes all rings and pending lines directly to the Display and disables buffering
+    // On panic, the locks are ignored, since whoever holds them is not coming back
+    static void synchronize(bool panic = false);
+
+private:
+    static void commit(Ring * ring);
+    static unsigned int drain(Ring * ring, char * buf, unsigned int max);
+    static bool flush();
+    static void write(const char * s);
+
+    static void lock(volatile bool & l) { while(CPU::tsl(l)); }
+    static bool try_lock(volatile bool & l) {
+        for(unsigned int i = 0; CPU::tsl(l); i++)
+            if(i == TRIES)
+                return false;
+        return true;
+    }
+    static void unlock(volatile bool & l) { l = false; }
+
+    static int run();
+
+    static void init();
+
+private:
+    static Ring _ring[CPUS];
+    static volatile bool _display;
+    static volatile bool _synchronous;
+};
+
+__END_SYS
+
+#endif
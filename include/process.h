@@ -23,6 +23,8 @@ class Thread
     friend class Alarm;                 // for lock()
     friend class System;                // for init()
     friend class IC;                    // for link() for priority ceiling
+    friend class Monitor;               // for _thread_count and _daemon_count
+    friend class Output_Buffer;         // for _thread_count and _daemon_count
 
 protected:
     static const bool preemptive = Traits<Thread>::Criterion::preemptive;
@@ -33,7 +35,9 @@ protected:
 
     static const unsigned int QUANTUM = Traits<Thread>::QUANTUM;
     static const unsigned int STACK_SIZE = Traits<Application>::STACK_SIZE;
+    static const bool painted_stacks = Traits<Thread>::painted_stacks;
     static const bool mp = Traits<Thread>::mp; // multi processing
+    static const unsigned int PMU_CHANNELS = (Traits<PMU>::VIRTUAL_CHANNELS < PMU::CHANNELS) ? Traits<PMU>::VIRTUAL_CHANNELS : PMU::CHANNELS;
 
     typedef CPU::Log_Addr Log_Addr;
     typedef CPU::Context Context;
@@ -62,14 +66,25 @@ public:
     // Thread Queue
     typedef Ordered_Queue<Thread, Criterion, Scheduler<Thread>::Element> Queue;
 
+    // Performance counters accumulated while the thread was running (see pmu_enable())
+    struct PMU_Context {
+        void enter() { for(unsigned int i = 0; i < PMU_CHANNELS; i++) last[i] = PMU::read(i); }
+        void leave() { for(unsigned int i = 0; i < PMU_CHANNELS; i++) count[i] += PMU::read(i) - last[i]; }
+
+        PMU::Count count[PMU_CHANNELS];
+        PMU::Count last[PMU_CHANNELS];  // counters on the CPU when the thread was last dispatched
+    };
+
     // Thread Configuration
     struct Configuration {
-        Configuration(const State & s = READY, const Criterion & c = NORMAL, unsigned int ss = STACK_SIZE)
-        : state(s), criterion(c), stack_size(ss) {}
+        Configuration(const State & s = READY, const Criterion & c = NORMAL, unsigned int ss = STACK_SIZE, const Color & sc = WHITE, bool sp = false)
+        : state(s), criterion(c), stack_size(ss), stack_color(sc), stack_scratchpad(sp) {}
 
         State state;
         Criterion criterion;
         unsigned int stack_size;
+        Color stack_color; // with Traits<System>::colorful
+        bool stack_scratchpad; // in scratchpad memory (or in the system's heap if the machine has none)
     };
 
 
@@ -81,7 +96,7 @@ public:
     ~Thread();
 
     const volatile State & state() const { return _state; }
-    const volatile Criterion::Statistics & statistics() { return criterion().statistics(); }
+    Criterion::Statistics statistics();
 
     const volatile Criterion & priority() const { return _link.rank(); }
     void priority(const Criterion & p);
@@ -95,6 +110,20 @@ public:
         }
     }
 
+    // Per-thread performance counters: once enabled, the PMU channels below Traits<PMU>::VIRTUAL_CHANNELS are charged
+    // to this thread only while it runs, regardless of preemptions and migrations (the events must be configured on all CPUs)
+    void pmu_enable();
+    void pmu_disable();
+    void pmu_reset();
+    PMU::Count pmu_read(PMU::Channel channel);
+
+    // Stack usage (with Traits<Thread>::painted_stacks, otherwise the whole stack): the deepest it has been, in bytes
+    unsigned int stack_high_water() const;
+
+    // One line per exited thread with its stack size, usage and recommended size, followed by a recommendation for
+    // Traits<Application>::STACK_SIZE (also printed when the last thread exits)
+    static void stack_report(OStream & os);
+
     int join();
     void pass();
     void suspend();
@@ -108,7 +137,7 @@ public:
     Criterion & criterion() { return const_cast<Criterion &>(_link.rank()); }
 
 protected:
-    void constructor_prologue(unsigned int stack_size);
+    void constructor_prologue(unsigned int stack_size, Color color = WHITE, bool scratchpad = false);
     void constructor_epilogue(Log_Addr entry, unsigned int stack_size);
 
     Queue::Element * link() { return &_link; }
@@ -150,27 +179,49 @@ protected:
 private:
     static void init();
 
+    // Painted stacks are filled with STACK_PAINT when created and have a canary right above the exit status (the first
+    // word), so overflows are detected at the next dispatch and the high-water mark is the first word not painted
+    static const unsigned long STACK_PAINT = static_cast<unsigned long>(0x5a5a5a5a5a5a5a5aULL);
+    static const unsigned long STACK_CANARY = static_cast<unsigned long>(0xc0ffee00deadbeefULL);
+    static const unsigned int STACK_RECORDS = Traits<Application>::MAX_THREADS;
+
+    struct Stack_Record {
+        const Thread * thread;
+        unsigned int size;
+        unsigned int used;
+    };
+
+    bool stack_overflown() const { return painted_stacks && (reinterpret_cast<const unsigned long *>(_stack)[1] != STACK_CANARY); }
+    void stack_record();
+    static unsigned int stack_recommended(unsigned int used);
+
 protected:
     char * _stack;
+    unsigned int _stack_size;
     Context * volatile _context;
     volatile State _state;
     Queue * _waiting;
     Thread * volatile _joining;
     Queue::Element _link;
     Priority_Stack _natural_priority;
+    PMU_Context * _pmu;
 
     static bool _not_booting;
     static volatile unsigned int _thread_count;
+    static volatile unsigned int _daemon_count; // system threads that exit by themselves once they are all that is left
     static Scheduler_Timer * _timer;
     static Scheduler<Thread> _scheduler;
     static Spin _spin;
     static volatile unsigned int _next_cpu;
+    static Stack_Record _stack_records[STACK_RECORDS];
+    static unsigned int _stack_recorded;
+    static unsigned int _stack_max; // the deepest stack of all exited threads
 };
 
 
 template<typename ... Tn>
 inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
-: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL)
+: _state(READY), _waiting(0), _joining(0), _link(this, NORMAL), _pmu(0)
 {
     constructor_prologue(STACK_SIZE);
     _context = CPU::init_stack(0, _stack + STACK_SIZE, &__exit, entry, an ...);
@@ -179,9 +230,9 @@ inline Thread::Thread(int (* entry)(Tn ...), Tn ... an)
 
 template<typename ... Tn>
 inline Thread::Thread(const Configuration & conf, int (* entry)(Tn ...), Tn ... an)
-: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion)
+: _state(conf.state), _waiting(0), _joining(0), _link(this, conf.criterion), _pmu(0)
 {
-    constructor_prologue(conf.stack_size);
+    constructor_prologue(conf.stack_size, conf.stack_color, conf.stack_scratchpad);
     _context = CPU::init_stack(0, _stack + conf.stack_size, &__exit, entry, an ...);
     constructor_epilogue(entry, conf.stack_size);
 }
@@ -37,8 +37,17 @@ protected:
     class Static_Handler: public Semaphore_Handler
     {
     public:
-        Static_Handler(Semaphore * s, Periodic_Thread * t): Semaphore_Handler(s) {}
+        Static_Handler(Semaphore * s, Periodic_Thread * t): Semaphore_Handler(s), _thread(t) {}
         ~Static_Handler() {}
+
+        void operator()() {
+            _thread->job_release();
+
+            Semaphore_Handler::operator()();
+        }
+
+    private:
+        Periodic_Thread * _thread;
     };
 
     // Alarm Handler for periodic threads under dynamic scheduling policies
@@ -49,6 +58,7 @@ protected:
         ~Dynamic_Handler() {}
 
         void operator()() {
+            _thread->job_release();
             _thread->criterion().update();
 
             Semaphore_Handler::operator()();
@@ -76,7 +86,7 @@ public:
     template<typename ... Tn>
     Periodic_Thread(const Microsecond & p, int (* entry)(Tn ...), Tn ... an)
     : Thread(Thread::Configuration(SUSPENDED, Criterion(p)), entry, an ...),
-      _semaphore(0), _handler(&_semaphore, this), _alarm(p, &_handler, INFINITE) { resume(); }
+      _semaphore(0), _handler(&_semaphore, this), _alarm(p, &_handler, INFINITE) { job_release(); resume(); }
 
     template<typename ... Tn>
     Periodic_Thread(const Configuration & conf, int (* entry)(Tn ...), Tn ... an)
@@ -84,6 +94,7 @@ public:
       _semaphore(0), _handler(&_semaphore, this), _alarm(conf.period, &_handler, conf.times) {
         if((conf.state == READY) || (conf.state == RUNNING)) {
             _state = SUSPENDED;
+            job_release();
             resume();
         } else
             _state = conf.state;
@@ -97,12 +108,19 @@ public:
 
         db<Thread>(TRC) << "Thread::wait_next(this=" << t << ",times=" << t->_alarm.times() << ")" << endl;
 
+        t->job_finish();
+
         if(t->_alarm.times())
             t->_semaphore.p();
 
         return t->_alarm.times();
     }
 
+protected:
+    // Job events are collected under the scheduler lock, since the alarm handler might run on another CPU
+    void job_release() { lock(); criterion().collect(Criterion::JOB_RELEASE); unlock(); }
+    void job_finish() { lock(); criterion().collect(Criterion::JOB_FINISH); unlock(); }
+
 protected:
     Semaphore _semaphore;
     Handler _handler;
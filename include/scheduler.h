@@ -87,8 +87,8 @@ public:
     static const unsigned int QUEUES = 1;
     static const unsigned int HEADS = Traits<System>::CPUS;
     
-    // Runtime Statistics (for policies that don't use any; that's why its a union)
-    union Statistics {
+    // Runtime Statistics (zero-initialized at construction; only real-time criteria collect them)
+    struct Statistics {
         // Thread related statistics
         Tick thread_creation;                   // tick in which the thread was created
         Tick thread_destruction;                // tick in which the thread was destroyed
@@ -99,16 +99,30 @@ public:
 
         // Job related statistics
         bool job_released;
+        bool job_started;                       // whether the current job has already got the CPU
+        bool job_missed;                        // whether the current job has already been accounted as a deadline miss
         Tick job_release;                       // tick in which the last job of a periodic thread was made ready for execution
         Tick job_start;                         // tick in which the last job of a periodic thread started (different from "thread_last_dispatch" since jobs can be preempted)
         Tick job_finish;                        // tick in which the last job of a periodic thread finished (i.e. called _alarm->p() at wait_netxt(); different from "thread_last_preemption" since jobs can be preempted)
         Tick job_utilization;                   // accumulated execution time (in ticks)
         unsigned int jobs_released;             // number of jobs of a thread that were released so far (i.e. the number of times _alarm->v() was called by the Alarm::handler())
+        unsigned int jobs_started;              // number of jobs of a thread that got the CPU for the first time so far
         unsigned int jobs_finished;             // number of jobs of a thread that finished execution so far (i.e. the number of times alarm->p() was called at wait_next())
 
+        // Real-time related statistics
+        unsigned int deadline_misses;           // number of jobs that missed their deadlines (either finished late or were still running at the next release)
+        Tick response_time_min;                 // shortest response time (job_finish - job_release) among finished jobs (in ticks)
+        Tick response_time_max;                 // longest response time among finished jobs (in ticks)
+        Tick response_time_sum;                 // accumulated response time of finished jobs (in ticks)
+        Tick start_latency_min;                 // shortest latency (job_start - job_release) among started jobs (in ticks)
+        Tick start_latency_max;                 // longest latency among started jobs (in ticks)
+
         // CPU related statistics
         Tick execution_per_cpu[Traits<System>::CPUS]; // Accumulated execution time PER CPU
-        
+
+        Tick response_time_avg() const { return jobs_finished ? response_time_sum / jobs_finished : 0; }
+        Tick response_time_jitter() const { return jobs_finished ? response_time_max - response_time_min : 0; }
+        Tick start_jitter() const { return jobs_started ? start_latency_max - start_latency_min : 0; }
     };
 
 protected:
@@ -207,6 +221,9 @@ public:
 // Real-time Algorithms
 class Real_Time_Scheduler_Common: public Priority
 {
+public:
+    static const bool collecting = true;
+
 protected:
     Real_Time_Scheduler_Common(int i): Priority(i), _period(0), _deadline(0), _capacity(0) {} // aperiodic
     Real_Time_Scheduler_Common(int i, const Microsecond & d, const Microsecond & p, const Microsecond & c)
@@ -223,14 +240,20 @@ public:
 
     volatile Statistics & statistics() { return _statistics; }
 
+    static unsigned int deadline_misses() { return _deadline_misses; }
+
 protected:
     static Tick elapsed();
     Tick ticks(Microsecond time);
     Microsecond time(Tick ticks);
 
+    void miss();
+
     Tick _period;
     Tick _deadline;
     Tick _capacity;
+
+    static volatile unsigned int _deadline_misses; // system-wide count of missed deadlines
 };
 
 // Rate Monotonic
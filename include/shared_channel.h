@@ -0,0 +1,103 @@
+// EPOS Shared Memory Channel Component Declarations
+
+#ifndef __shared_channel_h
+#define __shared_channel_h
+
+#include <utility/ring.h>
+#include <architecture.h>
+#include <memory.h>
+#include <synchronizer.h>
+
+__BEGIN_SYS
+
+// Shared Memory Channel
+// A Blocking_Ring of N (a power of two) messages of type T that lives in a Segment of its own, so it can be attached to
+// several Address_Spaces, each getting an Endpoint to it. Messages are copied straight into and out of the ring, which
+// is the only buffer involved, and single-producer/single-consumer channels can even be filled and drained in place
+// (reserve()/publish() and peek()/consume()). The ring is an MPMC_Ring with MULTI (for multiple producers and
+// consumers) and an SPSC_Ring otherwise, so the lock-free protocol and the blocking send() and receive(), which only
+// touch the Semaphores (kept in the Segment along with the ring) when the ring is full or empty, are those of ring.h.
+template<typename T, unsigned int N, bool MULTI = false>
+class Shared_Channel
+{
+private:
+    typedef Blocking_Ring<typename IF<MULTI, MPMC_Ring<T, N>, SPSC_Ring<T, N>>::Result, Semaphore> Ring;
+
+public:
+    typedef MMU::Flags Flags;
+
+    class Endpoint
+    {
+    public:
+        Endpoint(Shared_Channel * channel, Address_Space * as): _channel(channel), _as(as), _ring(as->attach(channel->_segment)) {}
+        ~Endpoint() { _as->detach(_channel->_segment); }
+
+        bool try_send(const T & item) { return _ring->insert(item); }
+        bool try_receive(T * item) { return _ring->remove(item); }
+
+        void send(const T & item) { _ring->put(item); }
+        void receive(T * item) { _ring->get(item); }
+
+        // Zero-copy interface (single producer and single consumer only): the slot returned by reserve() (or 0 if
+        // the ring is full) is filled in place and handed to the consumer by publish(); the one returned by peek()
+        // (or 0 if the ring is empty) is read in place and given back to the producer by consume()
+        T * reserve() {
+            static_assert(!MULTI, "Shared_Channel::reserve() is only available for a single producer!");
+            return _ring->reserve();
+        }
+
+        void publish() {
+            static_assert(!MULTI, "Shared_Channel::publish() is only available for a single producer!");
+            _ring->publish();
+        }
+
+        const T * peek() {
+            static_assert(!MULTI, "Shared_Channel::peek() is only available for a single consumer!");
+            return _ring->peek();
+        }
+
+        void consume() {
+            static_assert(!MULTI, "Shared_Channel::consume() is only available for a single consumer!");
+            _ring->consume();
+        }
+
+        unsigned long size() const { return _ring->size(); } // approximate when MULTI
+
+    private:
+        Shared_Channel * _channel;
+        Address_Space * _as;
+        Ring * _ring;
+    };
+
+public:
+    Shared_Channel(Flags flags = Flags::APPD): _segment(new (SYSTEM) Segment(sizeof(Ring), flags)) {
+        Address_Space self(MMU::current());
+        Ring * ring = self.attach(_segment);
+        new (ring) Ring;
+        self.detach(_segment);
+
+        db<Synchronizer>(TRC) << "Shared_Channel(N=" << N << ",multi=" << MULTI << ",seg=" << _segment << ") => " << this << endl;
+    }
+
+    ~Shared_Channel() {
+        db<Synchronizer>(TRC) << "~Shared_Channel(this=" << this << ")" << endl;
+
+        Address_Space self(MMU::current());
+        Ring * ring = self.attach(_segment);
+        ring->~Ring();
+        self.detach(_segment);
+        delete _segment;
+    }
+
+    Segment * segment() const { return _segment; }
+
+    Endpoint * attach(Address_Space * as) { return new (SYSTEM) Endpoint(this, as); }
+    void detach(Endpoint * ep) { delete ep; }
+
+private:
+    Segment * _segment;
+};
+
+__END_SYS
+
+#endif
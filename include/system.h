@@ -10,6 +10,38 @@
 
 __BEGIN_SYS
 
+// Heap carved from a Segment attached to an Address_Space (e.g. a task's or the system's)
+// When it runs out of memory, a new Segment, at least as large as the whole heap so far (so this seldom happens), is
+// attached right after the last one (or wherever it fits if that is taken) and its pages are added to the heap. Segments
+// already attached are never touched, since they hold live blocks (e.g. thread stacks). Blocks always return to their
+// heap through Heap::typed_free(), whatever the Address_Space or the CPU freeing them.
+class Segment_Heap: public Heap
+{
+private:
+    typedef CPU::Log_Addr Log_Addr;
+
+    static const unsigned int EXTENSIONS = 8; // each one at least doubles the heap
+
+public:
+    Segment_Heap(Address_Space * as, Segment * seg, Segment::Flags flags, Log_Addr addr = 0);
+
+    Segment * segment() const { return _segment; }
+
+private:
+    static void * grow(Heap * heap, unsigned long & bytes);
+
+private:
+    Segment * _segment;
+    MMU::Page_Directory * _pd;
+    Segment::Flags _flags;
+    Log_Addr _base;
+    Log_Addr _top;
+    unsigned long _size;
+    char _extension[EXTENSIONS * sizeof(Segment)]; // the Segments attached by grow(), which the heap cannot hold itself
+    unsigned int _extensions;
+};
+
+
 class Application
 {
     friend class Init_Application;
@@ -17,11 +49,16 @@ class Application
     friend void ::free(void *);
 
 private:
+    static const unsigned int HEAPS = (Traits<System>::multiheap && Traits<System>::heap_per_core) ? Traits<Build>::CPUS : 1;
+
     static void init();
 
+    // With heap_per_core, each CPU allocates from a heap of its own and so never contends for the others' locks
+    static Heap * heap() { return _heap[(HEAPS > 1) ? CPU::id() : 0]; }
+
 private:
-    static char _preheap[sizeof(Heap)];
-    static Heap * _heap;
+    static char _preheap[HEAPS * sizeof(Segment_Heap)];
+    static Heap * _heap[HEAPS];
 };
 
 class System
@@ -33,6 +70,8 @@ class System
     friend void ::free(void *);							// for _heap
     friend void * ::operator new(size_t, const EPOS::System_Allocator &);	// for _heap
     friend void * ::operator new[](size_t, const EPOS::System_Allocator &);	// for _heap
+    friend void * ::operator new(size_t, const EPOS::Color &);		// for _color_heap
+    friend void * ::operator new[](size_t, const EPOS::Color &);		// for _color_heap
     friend void ::operator delete(void *);					// for _heap
     friend void ::operator delete[](void *);					// for _heap
 
@@ -40,13 +79,17 @@ public:
     static System_Info * const info() { assert(_si); return _si; }
 
 private:
+    static const unsigned int COLORS = Traits<System>::colorful ? Traits<MMU>::COLORS : 1;
+    static const unsigned long COLOR_HEAP_SIZE = Traits<System>::HEAP_SIZE / COLORS;
+
     static void init();
 
 private:
     static System_Info * _si;
-    static char _preheap[(Traits<System>::multiheap ? sizeof(Segment) : 0) + sizeof(Heap)];
+    static char _preheap[Traits<System>::multiheap ? sizeof(Segment) + sizeof(Segment_Heap) : sizeof(Heap)];
     static Segment * _heap_segment;
     static Heap * _heap;
+    static Heap * _color_heap[COLORS]; // one per color but WHITE, whose memory comes from the system's heap
 };
 
 __END_SYS
@@ -57,7 +100,7 @@ extern "C"
     inline void * malloc(size_t bytes) {
         __USING_SYS;
         if(Traits<System>::multiheap)
-            return Application::_heap->alloc(bytes);
+            return Application::heap()->alloc(bytes);
         else
             return System::_heap->alloc(bytes);
     }
@@ -70,7 +113,7 @@ extern "C"
 
     inline void free(void * ptr) {
         __USING_SYS;
-        if(Traits<System>::multiheap)
+        if(Traits<System>::multiheap || Traits<System>::colorful)
             Heap::typed_free(ptr);
         else
             Heap::untyped_free(System::_heap, ptr);
@@ -94,6 +137,17 @@ inline void * operator new[](size_t bytes, const EPOS::System_Allocator & alloca
     return _SYS::System::_heap->alloc(bytes);
 }
 
+// Colored memory comes from frames whose physical address maps to the given set of LLC lines (with Traits<System>::colorful)
+inline void * operator new(size_t bytes, const EPOS::Color & color) {
+    if((color != EPOS::WHITE) && (color < _SYS::System::COLORS))
+        return _SYS::System::_color_heap[color]->alloc(bytes);
+    return _SYS::System::_heap->alloc(bytes);
+}
+
+inline void * operator new[](size_t bytes, const EPOS::Color & color) {
+    return operator new(bytes, color);
+}
+
 // Delete cannot be declared inline due to virtual destructors
 void operator delete(void * ptr);
 void operator delete[](void * ptr);
@@ -127,6 +127,7 @@ namespace EPOS {
 #define __EEPROM_H              __HEADER_MACH(eeprom)
 #define __UART_H                __HEADER_MACH(uart)
 #define __SPI_H                 __HEADER_MACH(spi)
+#define __SCRATCHPAD_H          __HEADER_MACH(scratchpad)
 #define __RS485_H               __HEADER_MACH(rs485)
 #define __USB_H                 __HEADER_MACH(usb)
 #define __I2C_H                 __HEADER_MACH(i2c)
@@ -206,6 +207,7 @@ namespace EPOS {
 #define __PMU_H                 __HEADER_ARCH(pmu)
 #define __UART_H                __HEADER_MACH(uart)
 #define __SPI_H                 __HEADER_MACH(spi)
+#define __SCRATCHPAD_H          __HEADER_MACH(scratchpad)
 
 #ifndef __standalone__
 #define __NIC_H                 __HEADER_MACH(nic)
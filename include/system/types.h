@@ -18,6 +18,12 @@ enum Color {
     WHITE = COLOR_0
 };
 
+// Hot data placement
+// Objects defined with __SCRATCHPAD_DATA (e.g. the scheduler's queues) go to a section of their own, which eposcc links at
+// Memory_Map::SCRATCHPAD on machines that map their scratchpad memory there; elsewhere, hot data at least stays together,
+// in cache lines of its own. The section name has no leading dot so the linker defines __start_ and __stop_scratchpad.
+#define __SCRATCHPAD_DATA __attribute__((section("scratchpad"), aligned(_SYS::Traits<_SYS::CPU>::CACHE_LINE_SIZE)))
+
 // Power Management Modes
 enum Power_Mode
 {
@@ -36,6 +36,7 @@ class Alarm
     friend class Thread;                        // for elapsed()
     friend class Real_Time_Scheduler_Common;    // for elapsed()
     friend class FCFS;                          // for ticks() and elapsed()
+    friend class Clerk<System>;                 // for time() and elapsed()
 
 private:
     typedef Timer_Common::Tick Tick;
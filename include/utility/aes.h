@@ -11,29 +11,44 @@
 __BEGIN_UTIL
 
 // EPOS 128-bit Advanced Encryption Standard (AES) Software Implementation
-// Adapted from https://github.com/kokke/tiny-AES128-C
+// Key expansion and tables adapted from https://github.com/kokke/tiny-AES128-C
+// Rounds take one lookup per byte into a T-table, which merges SubBytes, ShiftRows and MixColumns (a single 1 KB table
+// per direction, rotated to stand for the other three), and use a key schedule that is expanded once per key: key()
+// sets it for the single-argument encrypt() and decrypt() (as used by the CTR and GCM modes), while the ones that take
+// a key expand it only if it differs from the last one. When the compiler targets the AES instructions of ARMv8 (Crypto
+// Extensions) or x86 (AES-NI), encryption uses them instead.
 template<>
 class SWAES<16>: public AES_Common
 {
 private:
-    static const unsigned int Nb = 4; // number of columns comprising a _state
+    static const unsigned int Nb = 4; // number of columns comprising a state
     static const unsigned int Nk = 4; // number of 32 bit words in a key
     static const int Nr = 10; // number of rounds in AES cipher
 
-    typedef unsigned char State[4][4]; // array holding the intermediate results during decryption
-
 public:
     static const unsigned int KEY_SIZE = 16;
+    static const unsigned int BLOCK_SIZE = 16;
+
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || defined(__AES__)
+    static const bool hardware = true;
+#else
+    static const bool hardware = false;
+#endif
 
 public:
-    SWAES(const Mode & m = ECB): _mode(m) {
+    SWAES(const Mode & m = ECB): _mode(m), _keyed(false) {
         assert((m == ECB) || (m == CBC));
-        for(unsigned int i = 0; i < 23; i++)
-            iv[i] = 0;
+        for(unsigned int i = 0; i < BLOCK_SIZE; i++)
+            _iv[i] = 0;
     }
 
     Mode mode() { return _mode; }
 
+    void key(const unsigned char * k);
+
+    void encrypt(const unsigned char * data, unsigned char * result);
+    void decrypt(const unsigned char * data, unsigned char * result);
+
     void encrypt(const unsigned char * data, const unsigned char * key, unsigned char * result) { crypt(data, key, result, true); }
     void decrypt(const unsigned char * data, const unsigned char * key, unsigned char * result) { crypt(data, key, result, false); }
 
@@ -54,19 +69,20 @@ private:
             db<Ciphers>(INF) << "," << int(key[i]);
         db<Ciphers>(INF) << "}" << endl;
 
-        switch(_mode) {
-        case CBC:
-            if(encrypt)
-                cbc_encrypt_buffer(result, data, 16, key, iv);
-            else
-                cbc_decrypt_buffer(result, data, 16, key, iv);
-            break;
-        case ECB:
-            if(encrypt)
-                ebc_encrypt(data, key, result);
-            else
-                ebc_decrypt(data, key, result);
-            break;
+        if(!_keyed || memcmp(key, _key, KEY_SIZE))
+            this->key(key);
+
+        // Each call is a single block, so CBC chains from the (zero) IV every time
+        unsigned char block[BLOCK_SIZE];
+        if(encrypt) {
+            for(unsigned int i = 0; i < BLOCK_SIZE; i++)
+                block[i] = (_mode == CBC) ? data[i] ^ _iv[i] : data[i];
+            this->encrypt(block, result);
+        } else {
+            this->decrypt(data, result);
+            if(_mode == CBC)
+                for(unsigned int i = 0; i < BLOCK_SIZE; i++)
+                    result[i] ^= _iv[i];
         }
 
         db<Ciphers>(INF) << "AES::" << (encrypt ? "en" : "de") << "crypt:result = {" << int(result[0]);
@@ -75,48 +91,29 @@ private:
         db<Ciphers>(INF) << "}" << endl;
     }
 
-    void cbc_encrypt_buffer(unsigned char * output, const unsigned char * input, int length, const unsigned char * key, unsigned char * iv);
-    void cbc_decrypt_buffer(unsigned char * output, const unsigned char * input, int length, const unsigned char * key, unsigned char * iv);
-    void ebc_encrypt(const unsigned char * input, const unsigned char * key, unsigned char *output);
-    void ebc_decrypt(const unsigned char * input, const unsigned char * key, unsigned char *output);
-
     void expand_key();
-    void add_round_key(int round);
-    void sub_bytes();
-    void shift_rows();
-    void mix_columns();
-    void inv_mix_columns();
-    void inv_sub_bytes();
-    void inv_shift_rows();
-
-    void cipher();
-    void inv_cipher();
-
-    void block_copy(unsigned char * output, const unsigned char * input) { memcpy(output, input, KEY_SIZE); }
-
-    unsigned char xtime(unsigned char x) { return ((x<<1) ^ (((x>>7) & 1) * 0x1b)); }
-    unsigned char multiply(unsigned char x, unsigned char y) {
-        return (((y & 1) * x) ^
-                ((y >> 1 & 1) * xtime(x)) ^
-                ((y >> 2 & 1) * xtime(xtime(x))) ^
-                ((y >> 3 & 1) * xtime(xtime(xtime(x)))) ^
-                ((y >> 4 & 1) * xtime(xtime(xtime(xtime(x))))));
-    }
+    void hardware_encrypt(const unsigned char * data, unsigned char * result);
 
-    void xor_with_iv(unsigned char * buf) { for(unsigned int i = 0; i < KEY_SIZE; ++i) buf[i] ^= _iv[i]; }
+    static unsigned int ror(unsigned int w, unsigned int n) { return (w >> n) | (w << (32 - n)); }
+    static unsigned int word(unsigned int b0, unsigned int b1, unsigned int b2, unsigned int b3) { return (b0 << 24) | (b1 << 16) | (b2 << 8) | b3; }
+    static unsigned int load(const unsigned char * b) { return word(b[0], b[1], b[2], b[3]); }
+    static void store(unsigned char * b, unsigned int w) { b[0] = w >> 24; b[1] = w >> 16; b[2] = w >> 8; b[3] = w; }
 
 private:
     Mode _mode;
 
-    State * _state;
-    unsigned char _round_key[176];
-    const unsigned char * _key;
-    unsigned char * _iv; // initial Vector used only for CBC mode
-    unsigned char iv[23];
+    bool _keyed;
+    unsigned char _key[KEY_SIZE];
+    unsigned char _round_key[Nb * (Nr + 1) * 4];        // as the standard (and the AES instructions) lay it out
+    unsigned int _encryption_key[Nb * (Nr + 1)];        // big-endian words, for the T-tables
+    unsigned int _decryption_key[Nb * (Nr + 1)];        // reversed and inverse-mixed, for the equivalent inverse cipher
+    unsigned char _iv[BLOCK_SIZE];                      // initial vector, used only for CBC mode
 
     static const unsigned char sbox[256];
     static const unsigned char rsbox[256];
     static const unsigned char rcon[255];
+    static const unsigned int te[256];                  // {02}.S[x], S[x], S[x], {03}.S[x]
+    static const unsigned int td[256];                  // {0e}.S^-1[x], {09}.S^-1[x], {0d}.S^-1[x], {0b}.S^-1[x]
 };
 
 __END_UTIL
@@ -0,0 +1,121 @@
+// EPOS Benchmark Utility Declarations
+
+#ifndef __benchmark_h
+#define __benchmark_h
+
+#include <architecture.h>
+#include <utility/ostream.h>
+
+__BEGIN_UTIL
+
+// Measures an operation SAMPLES times, after a warmup, and reports its cost distribution in a single machine-readable
+// line, so results can be diffed across commits:
+//   bench <name> clock=<cycles|tsc> hz=<frequency> n=<samples> min=<> p50=<> p90=<> p99=<> max=<> mean=<>
+// The cost of reading the clock is calibrated away. Samples are kept in the object, so big instances should be global.
+template<unsigned int SAMPLES = 1000>
+class Benchmark
+{
+public:
+    typedef unsigned long long Count;
+
+    // CYCLES uses the PMU cycle counter of the current CPU (falls back to TSC when there is no PMU);
+    // TSC must be used for operations that span more than one CPU
+    enum Clock {
+        CYCLES,
+        TSC_TICKS
+    };
+
+    static const unsigned int CYCLE_CHANNEL = 0;
+
+public:
+    Benchmark(const char * name, Clock clock = CYCLES, unsigned int warmup = SAMPLES / 10)
+    : _name(name), _clock(Traits<PMU>::enabled ? clock : TSC_TICKS), _warmup(warmup), _overhead(0), _sorted(false) {
+        if(_clock == CYCLES)
+            PMU::config(CYCLE_CHANNEL, UNHALTED_CYCLES);
+        calibrate();
+    }
+
+    template<typename Operation>
+    void run(Operation op) {
+        for(unsigned int i = 0; i < _warmup; i++)
+            op();
+
+        for(unsigned int i = 0; i < SAMPLES; i++) {
+            Count begin = now();
+            op();
+            Count end = now();
+            _samples[i] = (end - begin > _overhead) ? end - begin - _overhead : 0;
+        }
+
+        _sorted = false;
+    }
+
+    Count min() { sort(); return _samples[0]; }
+    Count max() { sort(); return _samples[SAMPLES - 1]; }
+    Count percentile(unsigned int p) { sort(); return _samples[(SAMPLES - 1) * p / 100]; }
+
+    Count mean() {
+        Count sum = 0;
+        for(unsigned int i = 0; i < SAMPLES; i++)
+            sum += _samples[i];
+        return sum / SAMPLES;
+    }
+
+    Hertz frequency() const { return (_clock == CYCLES) ? Traits<CPU>::CLOCK : TSC::frequency(); }
+
+    void report(OStream & os) {
+        os << "bench " << _name
+           << " clock=" << ((_clock == CYCLES) ? "cycles" : "tsc")
+           << " hz=" << frequency()
+           << " n=" << SAMPLES
+           << " min=" << min()
+           << " p50=" << percentile(50)
+           << " p90=" << percentile(90)
+           << " p99=" << percentile(99)
+           << " max=" << max()
+           << " mean=" << mean() << endl;
+    }
+
+private:
+    Count now() const { return (_clock == CYCLES) ? Count(PMU::read(CYCLE_CHANNEL)) : Count(TSC::time_stamp()); }
+
+    // The clock overhead is the minimum cost of measuring nothing
+    void calibrate() {
+        _overhead = 0;
+        for(unsigned int i = 0; i < SAMPLES; i++) {
+            Count begin = now();
+            Count end = now();
+            if((i == 0) || (end - begin < _overhead))
+                _overhead = end - begin;
+        }
+    }
+
+    // Shell sort, to keep the harness free of recursion and dynamic memory
+    void sort() {
+        if(_sorted)
+            return;
+
+        for(unsigned int gap = SAMPLES / 2; gap > 0; gap /= 2)
+            for(unsigned int i = gap; i < SAMPLES; i++) {
+                Count tmp = _samples[i];
+                unsigned int j = i;
+                for(; (j >= gap) && (_samples[j - gap] > tmp); j -= gap)
+                    _samples[j] = _samples[j - gap];
+                _samples[j] = tmp;
+            }
+
+        _sorted = true;
+    }
+
+private:
+    const char * _name;
+    Clock _clock;
+    unsigned int _warmup;
+    Count _overhead;
+    bool _sorted;
+    Count _samples[SAMPLES];
+};
+
+__END_UTIL
+
+#endif
@@ -10,17 +10,24 @@ __BEGIN_UTIL
 // This class implements a prime finite field (Fp or GF(p))
 // It basically consists of (possibly) big numbers between 0 and a prime modulo, with + - * / operators
 // Primarily meant to be used primarily by asymmetric cryptography (e.g. Diffie-Hellman)
+// Digits are 64-bit wherever the compiler has 128-bit products (RV64 and ARMv8) and 32-bit elsewhere, but Words are always rounded up
+// to 64 bits, so the Montgomery radix R = 2^(8 * sizeof(Word)) and the constants in bignum.cc don't depend on the digit.
+// Products are reduced with Montgomery's method, which needs R^2 % _mod and -_mod^-1 % 2^64 for each SIZE.
 template<unsigned int SIZE>
 class Bignum
 {
-    template<typename Cipher> friend class Poly1305;
-
 public:
+#ifdef __SIZEOF_INT128__
+    typedef unsigned long Digit;
+    typedef unsigned __int128 Double_Digit;
+#else
     typedef unsigned int Digit;
     typedef unsigned long long Double_Digit;
+#endif
 
-    static const unsigned int DIGITS = (SIZE + sizeof(Digit) - 1) / sizeof(Digit);
+    static const unsigned int DIGITS = (SIZE + sizeof(long long) - 1) / sizeof(long long) * (sizeof(long long) / sizeof(Digit));
     static const unsigned int BITS_PER_DIGIT = sizeof(Digit) * 8;
+    static const unsigned int KARATSUBA_THRESHOLD = 8; // in digits; smaller products are computed by simple_mult()
 
     typedef Digit Word[DIGITS];
     typedef Double_Digit Double_Word[DIGITS];
@@ -30,20 +37,16 @@ private:
         unsigned char bytes[sizeof(Word)];
         Digit data[sizeof(Word) / sizeof(Digit)];
     };
-    union _Barrett {
-        unsigned char bytes[sizeof(Word) + sizeof(Digit)];
-        Digit data[sizeof(Word) / sizeof(Digit)];
-    };
 
 public:
-    Bignum(unsigned int n = 0) __attribute__((noinline)) {
+    Bignum(unsigned int n = 0) {
         *this = n;
     }
     Bignum(const void * bytes, unsigned int len) {
         for(unsigned int i = 0, j = 0; i < DIGITS; i++) {
             _data[i] = 0;
             for(unsigned int k = 0; k < sizeof(Digit) && j < len; k++, j++)
-                _data[i] += (reinterpret_cast<const unsigned char *>(bytes)[j] << (8 * k));
+                _data[i] += (Digit(reinterpret_cast<const unsigned char *>(bytes)[j]) << (8 * k));
         }
     }
 
@@ -97,15 +100,22 @@ public:
             db<Bignum>(TRC) << _mod.data[DIGITS - 1] << "]) => ";
         }
 
+        // (_data * b._data) / R, then (that * R^2) / R
         Digit mult_result[2 * DIGITS];
-        simple_mult(mult_result, _data, b._data, DIGITS);
-        barrett_reduction(_data, mult_result, DIGITS);
+        mult(mult_result, _data, b._data, DIGITS);
+        montgomery_reduction(_data, mult_result);
+        mult(mult_result, _data, _montgomery_r2.data, DIGITS);
+        montgomery_reduction(_data, mult_result);
+
+        // Only operands not smaller than _mod (e.g. built from bytes) can leave a result that is not either
+        while(cmp(_data, _mod.data, DIGITS) >= 0)
+            simple_sub(_data, _data, _mod.data, DIGITS);
 
         if(Traits<Bignum>::hysterically_debugged)
             db<Bignum>(TRC) << *this << endl;
     }
 
-    void operator+=(const Bignum &b)__attribute__((noinline)) { // _data = (_data + b._data) % _mod
+    void operator+=(const Bignum &b) { // _data = (_data + b._data) % _mod
         if(Traits<Bignum>::hysterically_debugged) {
             db<Bignum>(TRC) << "Bignum::operator+=(this=" << *this << ",other=" << b << ",mod=[";
             for(unsigned int i = 0; i < DIGITS - 1; i++)
@@ -122,7 +132,7 @@ public:
             db<Bignum>(TRC) << *this << endl;
     }
 
-    void operator-=(const Bignum &b)__attribute__((noinline)) { // _data = (_data - b._data) % _mod
+    void operator-=(const Bignum &b) { // _data = (_data - b._data) % _mod
         if(Traits<Bignum>::hysterically_debugged) {
             db<Bignum>(TRC) << "Bignum::operator-=(this=" << *this << ",other=" << b << ",mod=[";
             for(unsigned int i = 0; i < DIGITS - 1; i++)
@@ -189,13 +199,37 @@ public:
         return carry;
     }
 
+    // _data = (_data ^ e) % _mod, in a time that depends on neither (a Montgomery ladder over all bits of e)
+    void power(const Bignum & e) __attribute__((noinline)) {
+        Digit x0[DIGITS], x1[DIGITS], one[DIGITS];
+
+        one[0] = 1;
+        for(unsigned int i = 1; i < DIGITS; i++)
+            one[i] = 0;
+
+        // x0 = 1 * R % _mod, x1 = _data * R % _mod
+        montgomery_mult(x0, one, _montgomery_r2.data);
+        montgomery_mult(x1, _data, _montgomery_r2.data);
+
+        for(int bit = DIGITS * BITS_PER_DIGIT - 1; bit >= 0; bit--) {
+            Digit swap = (e._data[bit / BITS_PER_DIGIT] >> (bit % BITS_PER_DIGIT)) & 1;
+            conditional_swap(x0, x1, swap);
+            montgomery_mult(x1, x0, x1);
+            montgomery_mult(x0, x0, x0);
+            conditional_swap(x0, x1, swap);
+        }
+
+        // _data = x0 / R
+        montgomery_mult(_data, x0, one);
+    }
+
     void randomize() __attribute__((noinline)) { // Sets _data to a random number smaller than _mod
         int i;
         for(i = DIGITS - 1; i >= 0 && (_mod.data[i] == 0); i--)
             _data[i]=0;
-        _data[i] = Random::random() % _mod.data[i];
+        _data[i] = random_digit() % _mod.data[i];
         for(--i; i >= 0; i--)
-            _data[i] = Random::random();
+            _data[i] = random_digit();
     }
 
     void invert() __attribute__((noinline)) { // _data = i, such that (_data * i) % _mod = 1
@@ -238,7 +272,7 @@ public:
         unsigned int i;
         out << '[';
         for(i=0;i<DIGITS;i++) {
-            out << (unsigned int)b._data[i];
+            out << b._data[i];
             if(i < DIGITS-1)
                 out << ", ";
         }
@@ -250,7 +284,7 @@ public:
         unsigned int i;
         out << '[';
         for(i = 0; i < DIGITS; i++) {
-            out << (unsigned int)b._data[i];
+            out << b._data[i];
             if(i < DIGITS - 1)
                 out << ", ";
         }
@@ -272,14 +306,12 @@ private:
     // -No modulo applied
     // -a, b and res are assumed to have size 'size'
     // -a, b, res are allowed to point to the same place
-    static bool simple_sub(Digit * res, const Digit * a, const Digit * b, unsigned int size) __attribute__((noinline)) {
-        Double_Digit borrow = 0;
-        Double_Digit aux = Double_Digit(1) << BITS_PER_DIGIT;
+    static bool simple_sub(Digit * res, const Digit * a, const Digit * b, unsigned int size) {
+        Digit borrow = 0;
         for(unsigned int i = 0; i < size; i++) {
-            Double_Digit anow = a[i];
-            Double_Digit bnow = Double_Digit(b[i]) + borrow;
-            borrow = (anow < bnow);
-            res[i] = borrow ? (aux - bnow) + anow : anow - bnow;
+            Double_Digit tmp = Double_Digit(a[i]) - Double_Digit(b[i]) - borrow;
+            res[i] = tmp;
+            borrow = Digit(tmp >> BITS_PER_DIGIT) & 1;
         }
         return borrow;
     }
@@ -289,7 +321,7 @@ private:
     // -No modulo applied
     // -a, b and res are assumed to have size 'size'
     // -a, b, res are allowed to point to the same place
-    static bool simple_add(Digit * res, const Digit * a, const Digit * b, unsigned int size) __attribute__((noinline)) {
+    static bool simple_add(Digit * res, const Digit * a, const Digit * b, unsigned int size) {
         bool carry = 0;
         for(unsigned int i = 0; i < size; i++) {
             Double_Digit tmp = Double_Digit(carry) + Double_Digit(a[i]) + Double_Digit(b[i]);
@@ -328,80 +360,112 @@ private:
         res[i] = r0;
     }
 
-    // res = a % _mod
-    // - Intended to be used after a multiplication
-    // - res is assumed to be of size 'size'
-    // - a is assumed to be of size '2*size'
-    void barrett_reduction(Digit * res, const Digit * a, unsigned int size) {
-        Digit q[size + 1];
+    // res = (a * b)
+    // - Does not apply module
+    // - Karatsuba's method for large even sizes, simple_mult() otherwise; no branches depend on the operands
+    // - a and b are assumed to be of size 'size'
+    // - res is assumed to be of size '2*size'
+    static void mult(Digit * res, const Digit * a, const Digit * b, unsigned int size) {
+        if((size < KARATSUBA_THRESHOLD) || (size % 2)) {
+            simple_mult(res, a, b, size);
+            return;
+        }
 
-        // q = floor( ( floor( a/base^(size-1) ) * barrett_u ) / base^(size+1))
-        Double_Digit r0 = 0, r1 = 0, r2 = 0;
-        unsigned int i;
-        for(i = 0; i < (2 * (size + 1)) - 1; i++) {
-            for(unsigned int j = 0; (j < size + 1) && (j <= i); j++) {
-                unsigned int k = i - j;
-                if(k < size + 1) {
-                    // shifting left (little endian) size-1 places
-                    // a is assumed to have size size*2
-                    Double_Digit aj = a[j + (size - 1)];
-                    Double_Digit bk = _barrett_u.data[k];
-                    Double_Digit prod = aj * bk;
-                    r0 += Digit(prod);
-                    r1 += (prod >> BITS_PER_DIGIT) + (r0 >> BITS_PER_DIGIT);
-                    r0 = Digit(r0);
-                    r2 += r1 >> BITS_PER_DIGIT;
-                    r1 = Digit(r1);
-                }
-            }
-            // shifting left (little endian) size+1 places
-            if(i >= size + 1)
-                q[i - (size + 1)] = r0;
-            r0 = r1;
-            r1 = r2;
-            r2 = 0;
+        // a = a1 * base^h + a0, b = b1 * base^h + b0
+        // a * b = z2 * base^2h + (z1 - z2 - z0) * base^h + z0, with z1 = (a0 + a1) * (b0 + b1)
+        unsigned int h = size / 2;
+        Digit sa[h], sb[h], z1[2 * h + 2], z[2 * h];
+
+        Digit ca = simple_add(sa, a, a + h, h);
+        Digit cb = simple_add(sb, b, b + h, h);
+
+        mult(res, a, b, h);
+        mult(res + size, a + h, b + h, h);
+        mult(z1, sa, sb, h);
+
+        // The sums' carries contribute ca * sb * base^h + cb * sa * base^h + ca * cb * base^2h
+        Digit masked[h];
+        z1[2 * h] = ca & cb;
+        z1[2 * h + 1] = 0;
+        for(unsigned int i = 0; i < h; i++)
+            masked[i] = sb[i] & (0 - ca);
+        z1[2 * h] += simple_add(z1 + h, z1 + h, masked, h);
+        for(unsigned int i = 0; i < h; i++)
+            masked[i] = sa[i] & (0 - cb);
+        z1[2 * h] += simple_add(z1 + h, z1 + h, masked, h);
+
+        for(unsigned int i = 0; i < 2 * h; i++)
+            z[i] = res[i];
+        z1[2 * h] -= simple_sub(z1, z1, z, 2 * h);
+        for(unsigned int i = 0; i < 2 * h; i++)
+            z[i] = res[size + i];
+        z1[2 * h] -= simple_sub(z1, z1, z, 2 * h);
+
+        // res += z1 * base^h (z1 has 2h + 1 significant digits)
+        Digit carry = simple_add(res + h, res + h, z1, 2 * h + 1);
+        for(unsigned int i = 3 * h + 1; i < 2 * size; i++) {
+            Double_Digit tmp = Double_Digit(res[i]) + carry;
+            res[i] = tmp;
+            carry = tmp >> BITS_PER_DIGIT;
         }
-        q[i - (size + 1)] = r0;
+    }
 
-        Digit r[size + 1];
-        // r = (q * _mod) % base^(size+1)
-        r0 = 0, r1 = 0, r2 = 0;
-        for(i = 0; i < size + 1; i++) {
-            for(unsigned int j = 0; j <= i; j++) {
-                unsigned int k = i - j;
-                Double_Digit aj = q[j];
-                Double_Digit bk = (k == size ? 0 : _mod.data[k]);
-                Double_Digit prod = aj * bk;
-                r0 += Digit(prod);
-                r1 += (prod >> BITS_PER_DIGIT) + (r0 >> BITS_PER_DIGIT);
-                r0 = Digit(r0);
-                r2 += r1 >> BITS_PER_DIGIT;
-                r1 = Digit(r1);
+    // res = (t / R) % _mod, with R = base^DIGITS
+    // - Montgomery's reduction (separated operand scanning); t is overwritten
+    // - t is assumed to be of size '2*DIGITS' and smaller than _mod * R
+    // - res is smaller than _mod if t is smaller than _mod^2 (e.g. t = a * b, with a and b smaller than _mod)
+    // - Takes the same time for every t
+    static void montgomery_reduction(Digit * res, Digit * t) {
+        Digit inverse = Digit(_montgomery_inverse);
+        Digit overflow = 0;
+        for(unsigned int i = 0; i < DIGITS; i++) {
+            // Adding u * _mod clears digit i
+            Digit u = t[i] * inverse;
+            Double_Digit carry = 0;
+            for(unsigned int j = 0; j < DIGITS; j++) {
+                Double_Digit tmp = Double_Digit(u) * _mod.data[j] + t[i + j] + carry;
+                t[i + j] = tmp;
+                carry = tmp >> BITS_PER_DIGIT;
             }
-            r[i] = r0;
-            r0 = r1;
-            r1 = r2;
-            r2 = 0;
+            Double_Digit tmp = Double_Digit(t[i + DIGITS]) + carry + overflow;
+            t[i + DIGITS] = tmp;
+            overflow = tmp >> BITS_PER_DIGIT;
         }
 
-        // r = ((a % base^(size+1)) - r) % base^(size+1)
-        simple_sub(r, a, r, size+1);
+        // Subtract _mod if the result (overflow:t[DIGITS..]) is not smaller than it
+        Digit sub[DIGITS];
+        Digit borrow = simple_sub(sub, t + DIGITS, _mod.data, DIGITS);
+        Digit keep = 0 - (overflow | (borrow ^ 1));
+        for(unsigned int i = 0; i < DIGITS; i++)
+            res[i] = (sub[i] & keep) | (t[i + DIGITS] & ~keep);
+    }
+
+    // res = (a * b / R) % _mod
+    // - a and b are assumed to be smaller than _mod; res may point to either
+    static void montgomery_mult(Digit * res, const Digit * a, const Digit * b) {
+        Digit mult_result[2 * DIGITS];
+        mult(mult_result, a, b, DIGITS);
+        montgomery_reduction(res, mult_result);
+    }
 
-        // _data = r % _mod
-        while((r[size] > 0) || (cmp(r, _mod.data, size) >= 0)) {
-            if(simple_sub(r, r, _mod.data, size))
-                r[size]--;
+    // Swaps a and b if swap is 1, in the same time as if it is 0
+    static void conditional_swap(Digit * a, Digit * b, Digit swap) {
+        Digit mask = 0 - swap;
+        for(unsigned int i = 0; i < DIGITS; i++) {
+            Digit tmp = (a[i] ^ b[i]) & mask;
+            a[i] ^= tmp;
+            b[i] ^= tmp;
         }
-
-        for(unsigned int i = 0; i < size; i++)
-            res[i] = r[i];
     }
 
+    static Digit random_digit() { return Random::generator().next(); }
+
 private:
     Word _data;
 
     static const _Word _mod;
-    static const _Barrett _barrett_u;
+    static const _Word _montgomery_r2;                      // R^2 % _mod
+    static const unsigned long long _montgomery_inverse;    // -_mod^-1 % 2^64
 };
 
 __END_UTIL
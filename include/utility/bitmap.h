@@ -34,6 +34,8 @@ public:
         return false;
     }
 
+    bool operator[](unsigned int index) const { return (index < BITS) && (_map[index / BPI] & (1 << (index & mask))); }
+
     bool full(unsigned int upto) const {
         unsigned int i;
         for(i = 0; i < upto / BPI; i++)
@@ -0,0 +1,157 @@
+// EPOS Buddy Allocator Utility Declarations
+
+#ifndef __buddy_h
+#define __buddy_h
+
+#include <utility/bitmap.h>
+
+__BEGIN_UTIL
+
+// Buddy-system allocator for the FRAMES frames of FRAME_SIZE bytes starting at the physical address BASE
+// Free blocks span 2^order frames and are aligned (relative to BASE) to their own size. Each order has a doubly-linked
+// free list whose nodes live in the first frame of the free blocks themselves (reached through T::phy2log()) and a
+// bitmap marks the frames that head a free block, so a block's buddy can be checked and coalesced in constant time.
+// Requests are rounded up to a power of two and the surplus is given back, so alloc() and free() are O(log FRAMES) and
+// requests for exactly 2^order frames come aligned to 2^order frames (e.g. for huge pages).
+// As with the lists it replaces, address 0 means failure, so the frame at address 0 (if any) must never be freed.
+template<typename T, unsigned long BASE, unsigned long FRAMES, unsigned long FRAME_SIZE, unsigned int ORDERS>
+class Buddy_Allocator
+{
+private:
+    struct Node {
+        Node * prev;
+        Node * next;
+        unsigned long frame;
+        unsigned int order;
+    };
+
+public:
+    static const unsigned int MAX_ORDER = ORDERS - 1;
+
+public:
+    Buddy_Allocator(): _frames(0) {
+        for(unsigned int i = 0; i < ORDERS; i++) {
+            _head[i] = 0;
+            _blocks[i] = 0;
+        }
+    }
+
+    unsigned long alloc(unsigned long frames) {
+        unsigned int order = order_of(frames);
+        if(!frames || (order > MAX_ORDER))
+            return 0;
+
+        unsigned int k = order;
+        while((k <= MAX_ORDER) && !_head[k])
+            k++;
+        if(k > MAX_ORDER)
+            return 0;
+
+        unsigned long frame = pop(k);
+        while(k > order) { // split, keeping the lower half
+            k--;
+            push(frame + (1UL << k), k);
+        }
+        if(frames < (1UL << order)) // give back the frames beyond the request
+            release(frame + frames, (1UL << order) - frames);
+
+        return BASE + frame * FRAME_SIZE;
+    }
+
+    // Frames need not have been allocated together (nor by alloc()); the range is split into aligned blocks
+    void free(unsigned long addr, unsigned long frames) {
+        if((addr < BASE) || ((addr - BASE) / FRAME_SIZE >= FRAMES))
+            return;
+
+        unsigned long frame = (addr - BASE) / FRAME_SIZE;
+        if(frames > FRAMES - frame)
+            frames = FRAMES - frame;
+        release(frame, frames);
+    }
+
+    unsigned long allocable() const { // the largest block, in frames
+        for(int k = MAX_ORDER; k >= 0; k--)
+            if(_head[k])
+                return 1UL << k;
+        return 0;
+    }
+
+    unsigned long size() const { return _frames; }
+    unsigned long blocks(unsigned int order) const { return (order < ORDERS) ? _blocks[order] : 0; }
+
+private:
+    static unsigned int order_of(unsigned long frames) {
+        unsigned int order = 0;
+        while((1UL << order) < frames)
+            order++;
+        return order;
+    }
+
+    static Node * node(unsigned long frame) { return T::phy2log(BASE + frame * FRAME_SIZE); }
+
+    void release(unsigned long frame, unsigned long frames) {
+        while(frames) {
+            unsigned int order = 0;
+            while((order < MAX_ORDER) && !(frame & (1UL << order)) && ((2UL << order) <= frames))
+                order++;
+            coalesce(frame, order);
+            frame += 1UL << order;
+            frames -= 1UL << order;
+        }
+    }
+
+    void coalesce(unsigned long frame, unsigned int order) {
+        for(; order < MAX_ORDER; order++) {
+            unsigned long buddy = frame ^ (1UL << order);
+            if((buddy + (1UL << order) > FRAMES) || !_map[buddy] || (node(buddy)->order != order))
+                break;
+            remove(node(buddy));
+            frame &= ~(1UL << order);
+        }
+        push(frame, order);
+    }
+
+    void push(unsigned long frame, unsigned int order) {
+        Node * n = node(frame);
+        n->frame = frame;
+        n->order = order;
+        n->prev = 0;
+        n->next = _head[order];
+        if(_head[order])
+            _head[order]->prev = n;
+        _head[order] = n;
+
+        _map.set(frame);
+        _blocks[order]++;
+        _frames += 1UL << order;
+    }
+
+    unsigned long pop(unsigned int order) {
+        Node * n = _head[order];
+        remove(n);
+        return n->frame;
+    }
+
+    void remove(Node * n) {
+        if(n->prev)
+            n->prev->next = n->next;
+        else
+            _head[n->order] = n->next;
+        if(n->next)
+            n->next->prev = n->prev;
+
+        _map.reset(n->frame);
+        _blocks[n->order]--;
+        _frames -= 1UL << n->order;
+    }
+
+private:
+    Node * _head[ORDERS];
+    unsigned long _blocks[ORDERS];
+    unsigned long _frames;
+    Bitmap<FRAMES> _map;
+};
+
+__END_UTIL
+
+#endif
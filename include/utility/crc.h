@@ -7,26 +7,177 @@
 
 __BEGIN_UTIL
 
-class CRC
+// CRC instructions, when the compiler targets them: ARMv8 has both CRC-32 and CRC-32C (the CRC extension, implied by
+// -mcpu=cortex-a53) and SSE 4.2 has only CRC-32C. They update the register without the initial and final inversions.
+class CRC_Hardware
 {
 public:
-    static unsigned short crc16(char * ptr, int size) {
-        unsigned short crc = 0;
-
-        while(--size >= 0) {
-            crc ^= (unsigned short)(*ptr++) << 8;
-            int i = 8;
-            do{
-        	if(crc & 0x8000)
-        	    crc = (crc << 1) ^ 0x1021;
-        	else
-        	    crc = crc << 1;
-            } while(--i);
+    static const unsigned int CRC32_POLY = 0xedb88320;
+    static const unsigned int CRC32C_POLY = 0x82f63b78;
+
+#if defined(__ARM_FEATURE_CRC32)
+    static const bool crc32 = true;
+    static const bool crc32c = true;
+#elif defined(__SSE4_2__)
+    static const bool crc32 = false;
+    static const bool crc32c = true;
+#else
+    static const bool crc32 = false;
+    static const bool crc32c = false;
+#endif
+
+    static bool supports(unsigned int poly) { return ((poly == CRC32_POLY) && crc32) || ((poly == CRC32C_POLY) && crc32c); }
+
+    static unsigned int update(unsigned int poly, unsigned int crc, const unsigned char * data, unsigned long size) {
+        typedef unsigned long Word;
+
+        for(; size && (reinterpret_cast<Word>(data) & (sizeof(Word) - 1)); size--)
+            crc = step(poly, crc, *data++);
+        for(; size >= sizeof(Word); size -= sizeof(Word), data += sizeof(Word))
+            crc = step(poly, crc, *reinterpret_cast<const Word *>(data));
+        for(; size; size--)
+            crc = step(poly, crc, *data++);
+
+        return crc;
+    }
+
+private:
+    static unsigned int step(unsigned int poly, unsigned int crc, unsigned char b) {
+#if defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+        if(poly == CRC32_POLY)
+            ASM("crc32b %w0, %w0, %w1" : "+r"(crc) : "r"(b));
+        else
+            ASM("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"(b));
+#elif defined(__ARM_FEATURE_CRC32)
+        if(poly == CRC32_POLY)
+            ASM("crc32b %0, %0, %1" : "+r"(crc) : "r"(b));
+        else
+            ASM("crc32cb %0, %0, %1" : "+r"(crc) : "r"(b));
+#elif defined(__SSE4_2__)
+        ASM("crc32b %1, %0" : "+r"(crc) : "q"(b));
+#endif
+        return crc;
+    }
+
+    static unsigned int step(unsigned int poly, unsigned int crc, unsigned long w) {
+#if defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+        if(poly == CRC32_POLY)
+            ASM("crc32x %w0, %w0, %x1" : "+r"(crc) : "r"(w));
+        else
+            ASM("crc32cx %w0, %w0, %x1" : "+r"(crc) : "r"(w));
+#elif defined(__ARM_FEATURE_CRC32)
+        if(poly == CRC32_POLY)
+            ASM("crc32w %0, %0, %1" : "+r"(crc) : "r"(w));
+        else
+            ASM("crc32cw %0, %0, %1" : "+r"(crc) : "r"(w));
+#elif defined(__SSE4_2__) && defined(__x86_64__)
+        unsigned long c = crc;
+        ASM("crc32q %1, %0" : "+r"(c) : "rm"(w));
+        crc = c;
+#elif defined(__SSE4_2__)
+        ASM("crc32l %1, %0" : "+r"(crc) : "rm"(w));
+#endif
+        return crc;
+    }
+};
+
+
+// Table-driven CRC of WIDTH (8 to 32) bits, processing 8 bytes per step (slicing-by-8): _table[k][b] is the CRC of
+// byte b followed by k zero bytes, so the eight bytes of a step (the first ones XORed with the register) are looked up
+// independently. The tables are generated at compile time. REFLECTED CRCs shift LSB first, with the polynomial given
+// reversed. Objects accumulate a CRC over buffers fed by update(); compute() does a whole buffer at once.
+template<typename T, unsigned int WIDTH, T POLY, bool REFLECTED, T INIT, T XOROUT>
+class CRC_Engine
+{
+public:
+    typedef T Value;
+
+    static const unsigned int SLICES = 8;
+
+private:
+    static const T MASK = T(~0ULL >> (64 - WIDTH));
+    static const T TOP = T(1ULL << (WIDTH - 1));
+
+    struct Table
+    {
+        constexpr Table(): t() {
+            for(unsigned int b = 0; b < 256; b++) {
+                T c = REFLECTED ? T(b) : T(T(b) << (WIDTH - 8));
+                for(unsigned int i = 0; i < 8; i++)
+                    if(REFLECTED)
+                        c = (c & 1) ? T((c >> 1) ^ POLY) : T(c >> 1);
+                    else
+                        c = (c & TOP) ? T(((c << 1) ^ POLY) & MASK) : T((c << 1) & MASK);
+                t[0][b] = c;
+            }
+            for(unsigned int k = 1; k < SLICES; k++)
+                for(unsigned int b = 0; b < 256; b++)
+                    t[k][b] = zero(t[k - 1][b], t[0]);
+        }
+
+        static constexpr T zero(T c, const T * t0) {
+            return REFLECTED ? T((c >> 8) ^ t0[c & 0xff]) : T(((c << 8) ^ t0[(c >> (WIDTH - 8)) & 0xff]) & MASK);
+        }
+
+        T t[SLICES][256];
+    };
+
+public:
+    CRC_Engine(): _crc(INIT) {}
+
+    void reset() { _crc = INIT; }
+    void update(const void * data, unsigned long size) { _crc = update(_crc, data, size); }
+    T value() const { return _crc ^ XOROUT; }
+
+    static T compute(const void * data, unsigned long size) { return update(INIT, data, size) ^ XOROUT; }
+
+    // Raw register update, without the initial and final values
+    static T update(T crc, const void * data, unsigned long size) {
+        const unsigned char * d = reinterpret_cast<const unsigned char *>(data);
+
+        if((WIDTH == 32) && REFLECTED && CRC_Hardware::supports(POLY))
+            return CRC_Hardware::update(POLY, crc, d, size);
+
+        for(; size >= SLICES; size -= SLICES, d += SLICES) {
+            unsigned char b[SLICES];
+            for(unsigned int i = 0; i < SLICES; i++)
+                b[i] = d[i];
+            for(unsigned int i = 0; i < WIDTH / 8; i++)
+                b[i] ^= REFLECTED ? (crc >> (8 * i)) : (crc >> (WIDTH - 8 * (i + 1)));
+            crc = 0;
+            for(unsigned int i = 0; i < SLICES; i++)
+                crc ^= _table.t[SLICES - 1 - i][b[i]];
         }
 
+        for(; size; size--, d++)
+            if(REFLECTED)
+                crc = T((crc >> 8) ^ _table.t[0][(crc ^ *d) & 0xff]);
+            else
+                crc = T(((crc << 8) ^ _table.t[0][((crc >> (WIDTH - 8)) ^ *d) & 0xff]) & MASK);
+
         return crc;
     }
 
+private:
+    T _crc;
+
+    static constexpr Table _table{};
+};
+
+template<typename T, unsigned int WIDTH, T POLY, bool REFLECTED, T INIT, T XOROUT>
+constexpr typename CRC_Engine<T, WIDTH, POLY, REFLECTED, INIT, XOROUT>::Table CRC_Engine<T, WIDTH, POLY, REFLECTED, INIT, XOROUT>::_table;
+
+typedef CRC_Engine<unsigned short, 16, 0x1021, false, 0x0000, 0x0000> CRC16;                // CRC-16/XMODEM (CCITT polynomial)
+typedef CRC_Engine<unsigned int, 32, 0xedb88320, true, 0xffffffff, 0xffffffff> CRC32;       // CRC-32 (Ethernet, zlib)
+typedef CRC_Engine<unsigned int, 32, 0x82f63b78, true, 0xffffffff, 0xffffffff> CRC32C;      // CRC-32C (Castagnoli, iSCSI)
+
+
+class CRC
+{
+public:
+    static unsigned short crc16(char * ptr, int size) { return CRC16::compute(ptr, (size > 0) ? size : 0); }
+    static unsigned int crc32(const void * ptr, unsigned long size) { return CRC32::compute(ptr, size); }
+    static unsigned int crc32c(const void * ptr, unsigned long size) { return CRC32C::compute(ptr, size); }
 };
 
 __END_UTIL
@@ -0,0 +1,59 @@
+// EPOS Counter (CTR) Mode of Operation Utility Declarations
+
+#ifndef __ctr_h
+#define __ctr_h
+
+#include <utility/string.h>
+
+__BEGIN_UTIL
+
+// Turns a block cipher (e.g. AES<16>, already keyed) into a stream cipher: the key stream is the encryption of successive
+// values of a big-endian counter, of which only the last COUNTER_BYTES are incremented (4 for GCM, 16 for plain CTR).
+// Encryption and decryption are the same XOR with the key stream, which goes on across calls, so buffers of any length
+// can be streamed through crypt().
+template<typename Cipher, unsigned int COUNTER_BYTES = Cipher::BLOCK_SIZE>
+class CTR
+{
+public:
+    static const unsigned int BLOCK_SIZE = Cipher::BLOCK_SIZE;
+
+public:
+    CTR(Cipher * cipher, const unsigned char counter[BLOCK_SIZE]): _cipher(cipher), _used(BLOCK_SIZE) {
+        memcpy(_counter, counter, BLOCK_SIZE);
+    }
+
+    void crypt(const unsigned char * in, unsigned char * out, unsigned long size) {
+        for(; size && (_used < BLOCK_SIZE); size--)
+            *out++ = *in++ ^ _stream[_used++];
+
+        for(; size >= BLOCK_SIZE; size -= BLOCK_SIZE, in += BLOCK_SIZE, out += BLOCK_SIZE) {
+            next();
+            for(unsigned int i = 0; i < BLOCK_SIZE; i++)
+                out[i] = in[i] ^ _stream[i];
+        }
+
+        if(size) {
+            next();
+            for(_used = 0; size; size--)
+                *out++ = *in++ ^ _stream[_used++];
+        }
+    }
+
+    const unsigned char * counter() const { return _counter; }
+
+private:
+    void next() {
+        _cipher->encrypt(_counter, _stream);
+        for(unsigned int i = BLOCK_SIZE; (i > BLOCK_SIZE - COUNTER_BYTES) && !++_counter[i - 1]; i--);
+    }
+
+private:
+    Cipher * _cipher;
+    unsigned char _counter[BLOCK_SIZE];
+    unsigned char _stream[BLOCK_SIZE];
+    unsigned int _used; // bytes of _stream already consumed
+};
+
+__END_UTIL
+
+#endif
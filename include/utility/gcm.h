@@ -0,0 +1,192 @@
+// EPOS Galois/Counter Mode (GCM) Authenticated Encryption Utility Declarations
+
+#ifndef __gcm_h
+#define __gcm_h
+
+#include <utility/ctr.h>
+
+__BEGIN_UTIL
+
+// NIST SP 800-38D authenticated encryption on a 128-bit block cipher (e.g. AES<16>, already keyed), with 96-bit IVs.
+// Additional data goes through authenticate() before any text goes through encrypt() or decrypt(); all of them can be
+// called repeatedly with buffers of any length. tag() finishes the computation, and verify() compares a received tag
+// in constant time. GHASH multiplies by H in GF(2^128) 4 bits at a time (Shoup's method), with a 256-byte table per key.
+template<typename Cipher>
+class GCM
+{
+public:
+    static const unsigned int BLOCK_SIZE = Cipher::BLOCK_SIZE;
+    static const unsigned int IV_SIZE = 12;
+    static const unsigned int TAG_SIZE = 16;
+
+private:
+    typedef unsigned long long Half;
+
+public:
+    GCM(Cipher * cipher, const unsigned char iv[IV_SIZE]): _ctr(cipher, counter(iv)), _buffered(0), _aad_size(0), _text_size(0), _tagged(false) {
+        unsigned char h[BLOCK_SIZE];
+        memset(h, 0, BLOCK_SIZE);
+        cipher->encrypt(h, h);
+        table(h);
+
+        // The first counter block masks the tag; text starts from the second
+        memset(_tag_mask, 0, BLOCK_SIZE);
+        _ctr.crypt(_tag_mask, _tag_mask, BLOCK_SIZE);
+
+        memset(_x, 0, BLOCK_SIZE);
+    }
+
+    void authenticate(const unsigned char * aad, unsigned long size) {
+        hash(aad, size);
+        _aad_size += size;
+    }
+
+    void encrypt(const unsigned char * in, unsigned char * out, unsigned long size) {
+        start_text();
+        _ctr.crypt(in, out, size);
+        hash(out, size);
+        _text_size += size;
+    }
+
+    void decrypt(const unsigned char * in, unsigned char * out, unsigned long size) {
+        start_text();
+        hash(in, size);
+        _ctr.crypt(in, out, size);
+        _text_size += size;
+    }
+
+    // The lengths are hashed only by the first call, which leaves the tag in _x, so later ones (e.g. verify()) get the same
+    void tag(unsigned char out[TAG_SIZE]) {
+        if(!_tagged) {
+            flush();
+
+            unsigned char lengths[BLOCK_SIZE];
+            store(lengths, _aad_size * 8);
+            store(lengths + 8, _text_size * 8);
+            hash(lengths, BLOCK_SIZE);
+
+            for(unsigned int i = 0; i < TAG_SIZE; i++)
+                _x[i] ^= _tag_mask[i];
+            _tagged = true;
+        }
+
+        memcpy(out, _x, TAG_SIZE);
+    }
+
+    bool verify(const unsigned char received[TAG_SIZE]) {
+        unsigned char mine[TAG_SIZE];
+        tag(mine);
+
+        unsigned char diff = 0;
+        for(unsigned int i = 0; i < TAG_SIZE; i++)
+            diff |= mine[i] ^ received[i];
+        return !diff;
+    }
+
+private:
+    // J0 = IV || 0^31 || 1
+    const unsigned char * counter(const unsigned char iv[IV_SIZE]) {
+        memcpy(_j0, iv, IV_SIZE);
+        _j0[12] = 0; _j0[13] = 0; _j0[14] = 0; _j0[15] = 1;
+        return _j0;
+    }
+
+    // Additional data and text are padded to whole blocks separately
+    void start_text() {
+        if(!_text_size)
+            flush();
+    }
+
+    void flush() {
+        if(_buffered) {
+            multiply();
+            _buffered = 0;
+        }
+    }
+
+    void hash(const unsigned char * data, unsigned long size) {
+        for(; size; size--) {
+            _x[_buffered++] ^= *data++;
+            if(_buffered == BLOCK_SIZE) {
+                multiply();
+                _buffered = 0;
+            }
+        }
+    }
+
+    // _hl[i]:_hh[i] = i * H, for the 4-bit polynomials i (bit 3 is x^0)
+    void table(const unsigned char h[BLOCK_SIZE]) {
+        Half vh = load(h);
+        Half vl = load(h + 8);
+
+        _hl[8] = vl;
+        _hh[8] = vh;
+        _hl[0] = 0;
+        _hh[0] = 0;
+        for(unsigned int i = 4; i > 0; i >>= 1) {
+            Half t = (vl & 1) * 0xe1000000ULL;
+            vl = (vh << 63) | (vl >> 1);
+            vh = (vh >> 1) ^ (t << 32);
+            _hl[i] = vl;
+            _hh[i] = vh;
+        }
+        for(unsigned int i = 2; i <= 8; i *= 2)
+            for(unsigned int j = 1; j < i; j++) {
+                _hh[i + j] = _hh[i] ^ _hh[j];
+                _hl[i + j] = _hl[i] ^ _hl[j];
+            }
+    }
+
+    // _x = _x * H
+    void multiply() {
+        static const Half reduction[16] = {
+            0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+            0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0 };
+
+        unsigned int nibble = _x[15] & 0xf;
+        Half zh = _hh[nibble];
+        Half zl = _hl[nibble];
+
+        for(int i = 15; i >= 0; i--) {
+            for(unsigned int half = (i == 15) ? 1 : 0; half < 2; half++) {
+                nibble = half ? (_x[i] >> 4) : (_x[i] & 0xf);
+                unsigned int rem = zl & 0xf;
+                zl = (zh << 60) | (zl >> 4);
+                zh = (zh >> 4) ^ (reduction[rem] << 48);
+                zh ^= _hh[nibble];
+                zl ^= _hl[nibble];
+            }
+        }
+
+        store(_x, zh);
+        store(_x + 8, zl);
+    }
+
+    static Half load(const unsigned char * b) {
+        Half h = 0;
+        for(unsigned int i = 0; i < 8; i++)
+            h = (h << 8) | b[i];
+        return h;
+    }
+
+    static void store(unsigned char * b, Half h) {
+        for(int i = 7; i >= 0; i--, h >>= 8)
+            b[i] = h;
+    }
+
+private:
+    unsigned char _j0[BLOCK_SIZE];
+    CTR<Cipher, 4> _ctr;
+    unsigned char _tag_mask[BLOCK_SIZE];
+    unsigned char _x[BLOCK_SIZE];
+    unsigned int _buffered;
+    unsigned long long _aad_size;
+    unsigned long long _text_size;
+    bool _tagged;
+    Half _hl[16];
+    Half _hh[16];
+};
+
+__END_UTIL
+
+#endif
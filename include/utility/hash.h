@@ -205,6 +205,234 @@ private:
     List _table[SIZE];
 };
 
+
+// Open Addressing Hash Table with inline storage (after Google's Swiss Tables)
+// Objects and their keys are kept in the table itself, so no Elements have to be allocated and lookups walk no lists.
+// There are CAPACITY slots (SIZE rounded up to a power of two, with at least 1/8 of the slots always free) and a control
+// byte for each, telling whether the slot is empty, deleted or full, and in the latter case holding 7 bits of the key's
+// hash. Slots are probed in aligned groups of 8 whose control bytes are all matched against those 7 bits at once (with
+// vector compares if SSE2 or NEON are available, with bit tricks on a 64-bit word otherwise), so only slots that
+// probably hold the key have it compared, and a lookup stops at the first group with an empty slot. Removing from a
+// group that was never full empties the slot, otherwise it is marked deleted and reused by later insertions; when
+// deleted slots pile up, the table is rehashed in place. Keys are unique and must be convertible to unsigned long long.
+template<typename T, unsigned int SIZE, typename Key = int>
+class Open_Hash
+{
+private:
+    typedef unsigned long long Group;
+    typedef Group Group_Alias __attribute__((may_alias));
+
+    static const unsigned int GROUP = sizeof(Group);
+    static const unsigned char EMPTY = 0x80;
+    static const unsigned char DELETED = 0xfe; // full slots have the MSB clear
+    static const Group LSBS = 0x0101010101010101ULL;
+    static const Group MSBS = 0x8080808080808080ULL;
+
+    static constexpr unsigned int capacity(unsigned int c = GROUP) { return (c - c / 8 >= SIZE) ? c : capacity(2 * c); }
+
+public:
+    static const unsigned int CAPACITY = capacity();
+    static const unsigned int LIMIT = CAPACITY - CAPACITY / 8; // full plus deleted slots
+
+    typedef T Object_Type;
+    typedef Key Rank_Type;
+
+    class Element
+    {
+        friend class Open_Hash;
+
+    public:
+        T * object() const { return _object; }
+        const Key & key() const { return _key; }
+
+    private:
+        T * _object;
+        Key _key;
+    };
+
+    class Forward
+    {
+    public:
+        Forward(Open_Hash * hash, unsigned int slot): _hash(hash), _slot(slot) { skip(); }
+
+        Element & operator*() const { return _hash->_slots[_slot]; }
+        Element * operator->() const { return &_hash->_slots[_slot]; }
+
+        Forward & operator++() { _slot++; skip(); return *this; }
+        Forward operator++(int) { Forward tmp = *this; ++*this; return tmp; }
+
+        bool operator==(const Forward & i) const { return _slot == i._slot; }
+        bool operator!=(const Forward & i) const { return _slot != i._slot; }
+
+    private:
+        void skip() { for(; (_slot < CAPACITY) && !full(_hash->_control[_slot]); _slot++); }
+
+    private:
+        Open_Hash * _hash;
+        unsigned int _slot;
+    };
+
+    typedef Forward Iterator;
+
+public:
+    Open_Hash(): _size(0), _deleted(0) {
+        for(unsigned int i = 0; i < CAPACITY; i++)
+            _control[i] = EMPTY;
+    }
+
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end() { return Iterator(this, CAPACITY); }
+
+    bool empty() const { return _size == 0; }
+    unsigned int size() const { return _size; }
+
+    // Returns 0 if the table is full or already has the key
+    Element * insert(T * object, const Key & key) {
+        if((_size >= SIZE) || search_key(key))
+            return 0;
+
+        if(_size + _deleted >= LIMIT)
+            rehash();
+
+        Group h = hash(key);
+        unsigned int i = available(h);
+        if(_control[i] == DELETED)
+            _deleted--;
+        _control[i] = tag(h);
+        _slots[i]._object = object;
+        _slots[i]._key = key;
+        _size++;
+
+        return &_slots[i];
+    }
+
+    Object_Type * remove(const Object_Type * obj) {
+        Element * e = search(obj);
+        return e ? erase(e - _slots) : 0;
+    }
+
+    Object_Type * remove_key(const Key & key) {
+        Element * e = search_key(key);
+        return e ? erase(e - _slots) : 0;
+    }
+
+    Element * search(const Object_Type * obj) {
+        for(unsigned int i = 0; i < CAPACITY; i++)
+            if(full(_control[i]) && (_slots[i]._object == obj))
+                return &_slots[i];
+        return 0;
+    }
+
+    Element * search_key(const Key & key) {
+        Group h = hash(key);
+        for(unsigned int o = first(h), step = 0; ; o = next(o, ++step)) {
+            Group g = group(o);
+            for(Group m = match(g, tag(h)); m; m &= m - 1) {
+                unsigned int i = o + slot(m);
+                if(_slots[i]._key == key)
+                    return &_slots[i];
+            }
+            if(empties(g))
+                return 0;
+        }
+    }
+
+private:
+    static Group hash(const Key & key) {
+        Group h = static_cast<Group>(key) * 0x9e3779b97f4a7c15ULL;
+        return h ^ (h >> 32);
+    }
+    static unsigned char tag(Group h) { return h >> 57; }
+
+    // Groups are probed at triangular offsets from the first, which visits all of them
+    static unsigned int first(Group h) { return h & (CAPACITY - GROUP); }
+    static unsigned int next(unsigned int offset, unsigned int step) { return (offset + step * GROUP) & (CAPACITY - 1); }
+
+    static bool full(unsigned char c) { return !(c & 0x80); }
+
+    // Masks with the MSB of each byte of a group that matches: c (a few bytes above a match may also show up, but only
+    // full ones, whose keys are then compared), EMPTY, and EMPTY or DELETED
+    static Group match(Group g, unsigned char c) {
+#if defined(__SSE2__) || defined(__ARM_NEON)
+        typedef unsigned char Vector __attribute__((vector_size(GROUP)));
+        return reinterpret_cast<Group>(reinterpret_cast<Vector>(g) == c) & MSBS;
+#else
+        Group x = g ^ (LSBS * c);
+        return (x - LSBS) & ~x & MSBS;
+#endif
+    }
+    static Group empties(Group g) { return g & ~(g << 6) & MSBS; }
+    static Group availables(Group g) { return g & MSBS; }
+
+    static unsigned int slot(Group mask) {
+        return ((Traits<CPU>::ENDIANESS == Traits<CPU>::LITTLE) ? __builtin_ctzll(mask) : __builtin_clzll(mask)) / 8;
+    }
+
+    Group group(unsigned int offset) const { return *reinterpret_cast<const Group_Alias *>(&_control[offset]); }
+
+    // The first empty or deleted slot in the probe sequence of h
+    unsigned int available(Group h) const {
+        for(unsigned int o = first(h), step = 0; ; o = next(o, ++step)) {
+            Group m = availables(group(o));
+            if(m)
+                return o + slot(m);
+        }
+    }
+
+    Object_Type * erase(unsigned int i) {
+        // No lookup ever went past a group that still has an empty slot, so this one can be emptied too
+        if(empties(group(i & ~(GROUP - 1))))
+            _control[i] = EMPTY;
+        else {
+            _control[i] = DELETED;
+            _deleted++;
+        }
+        _size--;
+
+        return _slots[i]._object;
+    }
+
+    // Clears deleted slots by reinserting every element in place: full slots are first marked DELETED (still to be
+    // placed) and the others EMPTY; each element then stays if its first available slot is in its own group, moves if
+    // that slot is empty, or swaps with the element still to be placed there, which is handled next
+    void rehash() {
+        for(unsigned int i = 0; i < CAPACITY; i++)
+            _control[i] = full(_control[i]) ? DELETED : EMPTY;
+
+        for(unsigned int i = 0; i < CAPACITY; ) {
+            if(_control[i] != DELETED) {
+                i++;
+                continue;
+            }
+
+            Group h = hash(_slots[i]._key);
+            unsigned int j = available(h);
+            if(j / GROUP == i / GROUP) {
+                _control[i] = tag(h);
+                i++;
+            } else if(_control[j] == EMPTY) {
+                _slots[j] = _slots[i];
+                _control[j] = tag(h);
+                _control[i] = EMPTY;
+                i++;
+            } else {
+                Element tmp = _slots[j];
+                _slots[j] = _slots[i];
+                _slots[i] = tmp;
+                _control[j] = tag(h);
+            }
+        }
+
+        _deleted = 0;
+    }
+
+private:
+    unsigned char _control[CAPACITY] __attribute__((aligned(sizeof(Group))));
+    Element _slots[CAPACITY];
+    unsigned int _size;
+    unsigned int _deleted;
+};
+
 __END_UTIL
 
 #endif
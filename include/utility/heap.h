@@ -10,21 +10,32 @@
 __BEGIN_UTIL
 
 // Heap
+// Each heap has a lock of its own, so several heaps (e.g. one per CPU) can be used concurrently. A heap created with a
+// Grower calls it, with the lock held, whenever it runs out of memory; the Grower returns a new region of at least the
+// given number of bytes (updating it to the actual size), or 0 if the heap cannot grow any further.
 class Heap: private Grouping_List<char>
 {
 protected:
-    static const bool typed = Traits<System>::multiheap;
+    static const bool typed = Traits<System>::multiheap || Traits<System>::colorful; // several heaps share delete
+
+public:
+    typedef void * (Grower)(Heap * heap, unsigned long & bytes);
+
+protected:
+    Heap(Grower * grower): _grower(grower) {
+        db<Init, Heaps>(TRC) << "Heap(grower=" << reinterpret_cast<void *>(grower) << ") => " << this << endl;
+    }
 
 public:
     using Grouping_List<char>::empty;
     using Grouping_List<char>::size;
     using Grouping_List<char>::grouped_size;
 
-    Heap() {
+    Heap(): _grower(0) {
         db<Init, Heaps>(TRC) << "Heap() => " << this << endl;
     }
 
-    Heap(void * addr, unsigned long bytes) {
+    Heap(void * addr, unsigned long bytes): _grower(0) {
         db<Init, Heaps>(TRC) << "Heap(addr=" << addr << ",bytes=" << bytes << ") => " << this << endl;
 
         free(addr, bytes);
@@ -52,12 +63,15 @@ public:
         return tmp;
     }
 
-    void * alloc(unsigned long bytes) {
+    // Without room left (even after growing), panics, or returns 0 if told not to (e.g. to try elsewhere)
+    void * alloc(unsigned long bytes, bool panic = true) {
         _lock.acquire();
         db<Heaps>(TRC) << "Heap::alloc(this=" << this << ",bytes=" << bytes;
 
-        if(!bytes)
+        if(!bytes) {
+            _lock.release();
             return 0;
+        }
 
         if(!Traits<CPU>::unaligned_memory_access)
             while((bytes % sizeof(void *)))
@@ -70,9 +84,17 @@ public:
             bytes = sizeof(Element);
 
         Element * e = search_decrementing(bytes);
-        if(!e) {
-            out_of_memory(bytes);
-            return 0;
+        while(!e) {
+            unsigned long more = bytes;
+            void * region = _grower ? _grower(this, more) : 0;
+            if(!region) {
+                _lock.release();
+                if(panic)
+                    out_of_memory(bytes);
+                return 0;
+            }
+            add(region, more);
+            e = search_decrementing(bytes);
         }
 
         long * addr = reinterpret_cast<long *>(e->object() + e->size());
@@ -91,11 +113,7 @@ public:
         _lock.acquire();
         db<Heaps>(TRC) << "Heap::free(this=" << this << ",ptr=" << ptr << ",bytes=" << bytes << ")" << endl;
 
-        if(ptr && (bytes >= sizeof(Element))) {
-            Element * e = new (ptr) Element(reinterpret_cast<char *>(ptr), bytes);
-            Element * m1, * m2;
-            insert_merging(e, &m1, &m2);
-        }
+        add(ptr, bytes);
         _lock.release();
     }
 
@@ -113,8 +131,19 @@ public:
     }
 
 private:
+    void add(void * ptr, unsigned long bytes) {
+        if(ptr && (bytes >= sizeof(Element))) {
+            Element * e = new (ptr) Element(reinterpret_cast<char *>(ptr), bytes);
+            Element * m1, * m2;
+            insert_merging(e, &m1, &m2);
+        }
+    }
+
     void out_of_memory(unsigned long bytes);
-    static Simple_Spin _lock;
+
+private:
+    Grower * _grower;
+    Simple_Spin _lock;
 };
 
 __END_UTIL
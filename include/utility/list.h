@@ -290,6 +290,51 @@ namespace List_Elements
         Element * _prev;
         Element * _next;
     };
+
+    // Ordered Tree Element (also linked in order)
+    template<typename T, typename R = Rank>
+    class Doubly_Linked_Tree
+    {
+    public:
+        typedef T Object_Type;
+        typedef R Rank_Type;
+        typedef Doubly_Linked_Tree Element;
+
+    public:
+        Doubly_Linked_Tree(const T * o,  const R & r = 0): _object(o), _rank(r), _prev(0), _next(0), _parent(0), _left(0), _right(0), _red(false) {}
+
+        T * object() const { return const_cast<T *>(_object); }
+
+        Element * prev() const { return _prev; }
+        Element * next() const { return _next; }
+        void prev(Element * e) { _prev = e; }
+        void next(Element * e) { _next = e; }
+
+        Element * parent() const { return _parent; }
+        Element * left() const { return _left; }
+        Element * right() const { return _right; }
+        void parent(Element * e) { _parent = e; }
+        void left(Element * e) { _left = e; }
+        void right(Element * e) { _right = e; }
+
+        bool red() const { return _red; }
+        void red(bool r) { _red = r; }
+
+        const R & rank() const { return _rank; }
+        void rank(const R & r) { _rank = r; }
+        int promote(const R & n = 1) { _rank -= n; return _rank; }
+        int demote(const R & n = 1) { _rank += n; return _rank; }
+
+    private:
+        const T * _object;
+        R _rank;
+        Element * _prev;
+        Element * _next;
+        Element * _parent;
+        Element * _left;
+        Element * _right;
+        bool _red;
+    };
 };
 
 
@@ -1023,6 +1068,293 @@ template<typename T,
           typename El = List_Elements::Doubly_Linked_Ordered<T, R> >
 class Relative_List: public Ordered_List<T, R, El, true> {};
 
+// Doubly-Linked, Balanced Ordered List
+// Same interface as Ordered_List (which it can replace where ranks are absolute), but elements are also kept in a
+// red-black tree, so insert(), remove() and search_rank() take O(log n) instead of O(n). The tree only locates
+// positions: elements are still linked in order, so head(), tail() and iterators work as in any List. Elements of
+// equal rank are kept in insertion order and search_rank() finds the first of them.
+template<typename T,
+          typename R = List_Element_Rank,
+          typename El = List_Elements::Doubly_Linked_Tree<T, R> >
+class Ordered_Tree: public List<T, El>
+{
+private:
+    typedef List<T, El> Base;
+
+public:
+    typedef T Object_Type;
+    typedef R Rank_Type;
+    typedef El Element;
+    typedef List_Iterators::Bidirecional<El> Iterator;
+
+public:
+    Ordered_Tree(): _root(0) {}
+
+    using Base::empty;
+    using Base::size;
+    using Base::head;
+    using Base::tail;
+    using Base::begin;
+    using Base::end;
+    using Base::search;
+
+    void insert(Element * e) {
+        db<Lists>(TRC) << "Ordered_Tree::insert(e=" << e << ",o=" << (e ? e->object() : (void *) -1) << ")" << endl;
+
+        // Equal ranks go right, after those already there
+        Element * parent = 0;
+        bool left = false;
+        for(Element * n = _root; n; n = left ? n->left() : n->right()) {
+            parent = n;
+            left = e->rank() < n->rank();
+        }
+
+        e->parent(parent);
+        e->left(0);
+        e->right(0);
+        e->red(true);
+
+        // A new leaf is next to its parent in order
+        if(!parent) {
+            _root = e;
+            Base::insert_first(e);
+        } else if(left) {
+            parent->left(e);
+            if(parent->prev())
+                Base::insert(e, parent->prev(), parent);
+            else
+                Base::insert_head(e);
+        } else {
+            parent->right(e);
+            if(parent->next())
+                Base::insert(e, parent, parent->next());
+            else
+                Base::insert_tail(e);
+        }
+
+        rebalance_insertion(e);
+    }
+
+    Element * remove() {
+        db<Lists>(TRC) << "Ordered_Tree::remove()" << endl;
+
+        Element * e = head();
+        return e ? remove(e) : 0;
+    }
+
+    Element * remove(Element * e) {
+        db<Lists>(TRC) << "Ordered_Tree::remove(e=" << e << ",o=" << (e ? e->object() : (void *) -1) << ")" << endl;
+
+        unlink(e);
+        Base::remove(e);
+        return e;
+    }
+
+    Element * remove(const Object_Type * obj) {
+        db<Lists>(TRC) << "Ordered_Tree::remove(o=" << obj << ")" << endl;
+
+        Element * e = search(obj);
+        if(e)
+            return remove(e);
+        else
+            return 0;
+    }
+
+    Element * search_rank(const Rank_Type & rank) {
+        Element * found = 0;
+        for(Element * n = _root; n; )
+            if(n->rank() < rank)
+                n = n->right();
+            else {
+                if(!(rank < n->rank()))
+                    found = n;
+                n = n->left();
+            }
+        return found;
+    }
+
+    Element * remove_rank(const Rank_Type & rank) {
+        db<Lists>(TRC) << "Ordered_Tree::remove_rank(r=" << rank << ")" << endl;
+
+        Element * e = search_rank(rank);
+        if(e)
+            return remove(e);
+        return 0;
+    }
+
+private:
+    static bool red(Element * e) { return e && e->red(); }
+
+    void rotate_left(Element * x) {
+        Element * y = x->right();
+        x->right(y->left());
+        if(y->left())
+            y->left()->parent(x);
+        replace(x, y);
+        y->left(x);
+        x->parent(y);
+    }
+
+    void rotate_right(Element * x) {
+        Element * y = x->left();
+        x->left(y->right());
+        if(y->right())
+            y->right()->parent(x);
+        replace(x, y);
+        y->right(x);
+        x->parent(y);
+    }
+
+    // Puts v (possibly null) where u is in the tree
+    void replace(Element * u, Element * v) {
+        Element * p = u->parent();
+        if(!p)
+            _root = v;
+        else if(u == p->left())
+            p->left(v);
+        else
+            p->right(v);
+        if(v)
+            v->parent(p);
+    }
+
+    // Cormen et al., Introduction to Algorithms, 13.3
+    void rebalance_insertion(Element * z) {
+        for(Element * p; red(p = z->parent()); ) {
+            Element * g = p->parent(); // a red parent is never the root
+            if(p == g->left()) {
+                Element * u = g->right();
+                if(red(u)) {
+                    p->red(false);
+                    u->red(false);
+                    g->red(true);
+                    z = g;
+                } else {
+                    if(z == p->right()) {
+                        rotate_left(p);
+                        p = z;
+                    }
+                    p->red(false);
+                    g->red(true);
+                    rotate_right(g);
+                    break;
+                }
+            } else {
+                Element * u = g->left();
+                if(red(u)) {
+                    p->red(false);
+                    u->red(false);
+                    g->red(true);
+                    z = g;
+                } else {
+                    if(z == p->left()) {
+                        rotate_right(p);
+                        p = z;
+                    }
+                    p->red(false);
+                    g->red(true);
+                    rotate_left(g);
+                    break;
+                }
+            }
+        }
+        _root->red(false);
+    }
+
+    // Cormen et al., Introduction to Algorithms, 13.4, with null leaves, so the parent of x is tracked apart
+    void unlink(Element * z) {
+        Element * x;
+        Element * xp;
+        bool removed_red = z->red();
+
+        if(!z->left() || !z->right()) {
+            x = z->left() ? z->left() : z->right();
+            xp = z->parent();
+            replace(z, x);
+        } else {
+            Element * y = z->next(); // the in-order successor, leftmost in z's right subtree
+            removed_red = y->red();
+            x = y->right();
+            if(y->parent() == z)
+                xp = y;
+            else {
+                xp = y->parent();
+                replace(y, x);
+                y->right(z->right());
+                y->right()->parent(y);
+            }
+            replace(z, y);
+            y->left(z->left());
+            y->left()->parent(y);
+            y->red(z->red());
+        }
+
+        if(!removed_red)
+            rebalance_removal(x, xp);
+    }
+
+    void rebalance_removal(Element * x, Element * xp) {
+        while((x != _root) && !red(x)) {
+            if(x == xp->left()) {
+                Element * w = xp->right();
+                if(red(w)) {
+                    w->red(false);
+                    xp->red(true);
+                    rotate_left(xp);
+                    w = xp->right();
+                }
+                if(!red(w->left()) && !red(w->right())) {
+                    w->red(true);
+                    x = xp;
+                    xp = x->parent();
+                } else {
+                    if(!red(w->right())) {
+                        w->left()->red(false);
+                        w->red(true);
+                        rotate_right(w);
+                        w = xp->right();
+                    }
+                    w->red(xp->red());
+                    xp->red(false);
+                    w->right()->red(false);
+                    rotate_left(xp);
+                    x = _root;
+                }
+            } else {
+                Element * w = xp->left();
+                if(red(w)) {
+                    w->red(false);
+                    xp->red(true);
+                    rotate_right(xp);
+                    w = xp->left();
+                }
+                if(!red(w->left()) && !red(w->right())) {
+                    w->red(true);
+                    x = xp;
+                    xp = x->parent();
+                } else {
+                    if(!red(w->left())) {
+                        w->right()->red(false);
+                        w->red(true);
+                        rotate_left(w);
+                        w = xp->left();
+                    }
+                    w->red(xp->red());
+                    xp->red(false);
+                    w->left()->red(false);
+                    rotate_right(xp);
+                    x = _root;
+                }
+            }
+        }
+        if(x)
+            x->red(false);
+    }
+
+private:
+    Element * _root;
+};
+
 
 // Doubly-Linked, Typed List
 template<typename T = void,
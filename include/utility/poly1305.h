@@ -4,68 +4,277 @@
 #define __poly1305_h
 
 #include <utility/string.h>
-#include <utility/bignum.h>
-#include <utility/math.h>
 
 __BEGIN_UTIL
 
+// Messages are authenticated as they stream in: init() starts a MAC for a nonce, update() takes buffers of any length
+// (whole blocks are processed in place, only a partial one is kept between calls) and finish() outputs the tag.
+// stamp() and verify() do it all for a message in memory.
+// The accumulator h and the key r are kept in limbs small enough for their products to be summed without overflow,
+// after poly1305-donna: 3x44 bits with 64x64->128-bit multiplies (RV64, ARMv8), 5x26 bits with 32x32->64-bit otherwise.
+// Reduction modulo 2^130 - 5 folds whatever is above 2^130 back in multiplied by 5, and the key's limbs are premultiplied
+// by 5 (and by 4 for the 42-bit limb) for that.
 template<typename Cipher>
 class Poly1305
 {
-    typedef _UTIL::Bignum<17> Bignum;
+public:
+    static const unsigned int KEY_SIZE = 16;
+    static const unsigned int BLOCK_SIZE = 16;
+    static const unsigned int TAG_SIZE = 16;
+
+private:
+#ifdef __SIZEOF_INT128__
+    typedef unsigned long long Limb;
+    typedef unsigned __int128 Double_Limb;
+
+    static const unsigned int LIMBS = 3;
+#else
+    typedef unsigned int Limb;
+    typedef unsigned long long Double_Limb;
+
+    static const unsigned int LIMBS = 5;
+#endif
 
 public:
-    Poly1305(const unsigned char k[16], const unsigned char r[16]) : _k(k, 16), _r(r, 16) {
-        clamp();
+    Poly1305(const unsigned char k[KEY_SIZE], const unsigned char r[KEY_SIZE]) {
+        this->k(k);
+        this->r(r);
     }
     Poly1305() {}
 
-    void stamp(unsigned char out[16], const unsigned char nonce[16], const unsigned char * message, int message_len) {
-        // cr = (c_1 * r^q + c_2 * r^(q-1) + ... + c_q * r^1) % (2^130 - 5)
-        Bignum cr(0);
-        for(; message_len > 0; message_len -= 16, message += 16) {
-            int len = Math::min(16, message_len);
-            Bignum c(message, len);
-            reinterpret_cast<unsigned char *>(c._data)[len] = 1;
+    void init(const unsigned char nonce[BLOCK_SIZE]) {
+        _cipher.encrypt(nonce, _k, _s);
+        for(unsigned int i = 0; i < LIMBS; i++)
+            _h[i] = 0;
+        _buffered = 0;
+    }
 
-            cr += c;
-            cr *= _r;
+    void update(const unsigned char * data, unsigned long size) {
+        if(_buffered) {
+            for(; size && (_buffered < BLOCK_SIZE); size--)
+                _buffer[_buffered++] = *data++;
+            if(_buffered < BLOCK_SIZE)
+                return;
+            blocks(_buffer, BLOCK_SIZE, true);
+            _buffered = 0;
         }
 
-        unsigned char ciphertext[16];
-        Cipher cipher;
-        cipher.encrypt(nonce, reinterpret_cast<const unsigned char *>(_k._data), ciphertext);
+        unsigned long whole = size & ~(BLOCK_SIZE - 1);
+        blocks(data, whole, true);
 
-        // out = (cr + aes(k,n)) % 2^128
-        Bignum::simple_add(reinterpret_cast<Bignum::Digit *>(out), reinterpret_cast<const Bignum::Digit *>(ciphertext), cr._data, 4);
+        for(data += whole, size -= whole; size; size--)
+            _buffer[_buffered++] = *data++;
     }
 
-    bool verify(const unsigned char mac[16], const unsigned char nonce[16], const unsigned char * message, unsigned int message_len) {
-        unsigned char my_mac[16];
-        stamp(my_mac, nonce, message, message_len);
-        for(int i = 0; i < 16; i++) {
-            if(my_mac[i] != mac[i])
-                return false;
+    void finish(unsigned char out[TAG_SIZE]) {
+        // A partial last block is padded with a 1 and then zeros, instead of having 2^128 added
+        if(_buffered) {
+            _buffer[_buffered++] = 1;
+            for(; _buffered < BLOCK_SIZE; _buffered++)
+                _buffer[_buffered] = 0;
+            blocks(_buffer, BLOCK_SIZE, false);
+            _buffered = 0;
         }
-        return true;
+
+        tag(out);
+    }
+
+    void stamp(unsigned char out[TAG_SIZE], const unsigned char nonce[BLOCK_SIZE], const unsigned char * message, int message_len) {
+        init(nonce);
+        update(message, (message_len > 0) ? message_len : 0);
+        finish(out);
+    }
+
+    bool verify(const unsigned char mac[TAG_SIZE], const unsigned char nonce[BLOCK_SIZE], const unsigned char * message, unsigned int message_len) {
+        unsigned char my_mac[TAG_SIZE];
+        stamp(my_mac, nonce, message, message_len);
+
+        unsigned char diff = 0;
+        for(unsigned int i = 0; i < TAG_SIZE; i++)
+            diff |= my_mac[i] ^ mac[i];
+        return !diff;
     }
 
-    void k(const unsigned char k1[16]) { new (&_k) Bignum(k1,16); }
-    void r(const unsigned char r1[16]) { new (&_r) Bignum(r1,16); clamp(); }
+    void k(const unsigned char k1[KEY_SIZE]) { memcpy(_k, k1, KEY_SIZE); }
+
+    void r(const unsigned char r1[KEY_SIZE]) {
+        unsigned char r[KEY_SIZE];
+        memcpy(r, r1, KEY_SIZE);
+        clamp(r);
+
+#ifdef __SIZEOF_INT128__
+        Limb t0 = load64(r);
+        Limb t1 = load64(r + 8);
+        _r[0] = t0 & 0xfffffffffffULL;
+        _r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffffffffULL;
+        _r[2] = (t1 >> 24) & 0x3ffffffffffULL;
+#else
+        _r[0] = load32(r) & 0x3ffffff;
+        _r[1] = (load32(r + 3) >> 2) & 0x3ffffff;
+        _r[2] = (load32(r + 6) >> 4) & 0x3ffffff;
+        _r[3] = (load32(r + 9) >> 6) & 0x3ffffff;
+        _r[4] = (load32(r + 12) >> 8) & 0x3ffffff;
+#endif
+    }
 
 private:
-    void clamp() {
-        reinterpret_cast<unsigned char *>(_r._data)[3] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[7] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[11] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[15] &= 15;
-        reinterpret_cast<unsigned char *>(_r._data)[4] &= 252;
-        reinterpret_cast<unsigned char *>(_r._data)[8] &= 252;
-        reinterpret_cast<unsigned char *>(_r._data)[12] &= 252;
+    static void clamp(unsigned char r[KEY_SIZE]) {
+        r[3] &= 15;
+        r[7] &= 15;
+        r[11] &= 15;
+        r[15] &= 15;
+        r[4] &= 252;
+        r[8] &= 252;
+        r[12] &= 252;
+    }
+
+    static unsigned int load32(const unsigned char * b) { return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<unsigned int>(b[3]) << 24); }
+    static unsigned long long load64(const unsigned char * b) { return load32(b) | (static_cast<unsigned long long>(load32(b + 4)) << 32); }
+
+    static void store32(unsigned char * b, unsigned int w) { b[0] = w; b[1] = w >> 8; b[2] = w >> 16; b[3] = w >> 24; }
+    static void store64(unsigned char * b, unsigned long long w) { store32(b, w); store32(b + 4, w >> 32); }
+
+#ifdef __SIZEOF_INT128__
+    // h = (h + m) * r % (2^130 - 5), for each block m (with 2^128 added if full)
+    void blocks(const unsigned char * m, unsigned long size, bool full) {
+        const Limb mask = 0xfffffffffffULL;
+        const Limb hibit = full ? (1ULL << 40) : 0;
+        const Limb r0 = _r[0], r1 = _r[1], r2 = _r[2];
+        const Limb s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2];
+
+        for(; size >= BLOCK_SIZE; size -= BLOCK_SIZE, m += BLOCK_SIZE) {
+            Limb t0 = load64(m);
+            Limb t1 = load64(m + 8);
+            h0 += t0 & mask;
+            h1 += ((t0 >> 44) | (t1 << 20)) & mask;
+            h2 += ((t1 >> 24) & 0x3ffffffffffULL) | hibit;
+
+            Double_Limb d0 = Double_Limb(h0) * r0 + Double_Limb(h1) * s2 + Double_Limb(h2) * s1;
+            Double_Limb d1 = Double_Limb(h0) * r1 + Double_Limb(h1) * r0 + Double_Limb(h2) * s2;
+            Double_Limb d2 = Double_Limb(h0) * r2 + Double_Limb(h1) * r1 + Double_Limb(h2) * r0;
+
+            Limb c = Limb(d0 >> 44); h0 = Limb(d0) & mask;
+            d1 += c; c = Limb(d1 >> 44); h1 = Limb(d1) & mask;
+            d2 += c; c = Limb(d2 >> 42); h2 = Limb(d2) & 0x3ffffffffffULL;
+            h0 += c * 5; c = h0 >> 44; h0 &= mask;
+            h1 += c;
+        }
+
+        _h[0] = h0; _h[1] = h1; _h[2] = h2;
+    }
+
+    // out = (h % (2^130 - 5) + s) % 2^128
+    void tag(unsigned char out[TAG_SIZE]) {
+        const Limb mask = 0xfffffffffffULL;
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2];
+
+        Limb c = h1 >> 44; h1 &= mask;
+        h2 += c; c = h2 >> 42; h2 &= 0x3ffffffffffULL;
+        h0 += c * 5; c = h0 >> 44; h0 &= mask;
+        h1 += c; c = h1 >> 44; h1 &= mask;
+        h2 += c; c = h2 >> 42; h2 &= 0x3ffffffffffULL;
+        h0 += c * 5; c = h0 >> 44; h0 &= mask;
+        h1 += c;
+
+        // g = h - (2^130 - 5), taken instead of h if it does not borrow
+        Limb g0 = h0 + 5; c = g0 >> 44; g0 &= mask;
+        Limb g1 = h1 + c; c = g1 >> 44; g1 &= mask;
+        Limb g2 = h2 + c - (1ULL << 42);
+        Limb select = (g2 >> 63) - 1;
+        h0 = (h0 & ~select) | (g0 & select);
+        h1 = (h1 & ~select) | (g1 & select);
+        h2 = (h2 & ~select) | (g2 & select);
+
+        Limb t0 = load64(_s);
+        Limb t1 = load64(_s + 8);
+        h0 += t0 & mask; c = h0 >> 44; h0 &= mask;
+        h1 += (((t0 >> 44) | (t1 << 20)) & mask) + c; c = h1 >> 44; h1 &= mask;
+        h2 += ((t1 >> 24) & 0x3ffffffffffULL) + c; h2 &= 0x3ffffffffffULL;
+
+        store64(out, h0 | (h1 << 44));
+        store64(out + 8, (h1 >> 20) | (h2 << 24));
+    }
+#else
+    // h = (h + m) * r % (2^130 - 5), for each block m (with 2^128 added if full)
+    void blocks(const unsigned char * m, unsigned long size, bool full) {
+        const Limb mask = 0x3ffffff;
+        const Limb hibit = full ? (1 << 24) : 0;
+        const Limb r0 = _r[0], r1 = _r[1], r2 = _r[2], r3 = _r[3], r4 = _r[4];
+        const Limb s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2], h3 = _h[3], h4 = _h[4];
+
+        for(; size >= BLOCK_SIZE; size -= BLOCK_SIZE, m += BLOCK_SIZE) {
+            h0 += load32(m) & mask;
+            h1 += (load32(m + 3) >> 2) & mask;
+            h2 += (load32(m + 6) >> 4) & mask;
+            h3 += (load32(m + 9) >> 6) & mask;
+            h4 += (load32(m + 12) >> 8) | hibit;
+
+            Double_Limb d0 = Double_Limb(h0) * r0 + Double_Limb(h1) * s4 + Double_Limb(h2) * s3 + Double_Limb(h3) * s2 + Double_Limb(h4) * s1;
+            Double_Limb d1 = Double_Limb(h0) * r1 + Double_Limb(h1) * r0 + Double_Limb(h2) * s4 + Double_Limb(h3) * s3 + Double_Limb(h4) * s2;
+            Double_Limb d2 = Double_Limb(h0) * r2 + Double_Limb(h1) * r1 + Double_Limb(h2) * r0 + Double_Limb(h3) * s4 + Double_Limb(h4) * s3;
+            Double_Limb d3 = Double_Limb(h0) * r3 + Double_Limb(h1) * r2 + Double_Limb(h2) * r1 + Double_Limb(h3) * r0 + Double_Limb(h4) * s4;
+            Double_Limb d4 = Double_Limb(h0) * r4 + Double_Limb(h1) * r3 + Double_Limb(h2) * r2 + Double_Limb(h3) * r1 + Double_Limb(h4) * r0;
+
+            Limb c = Limb(d0 >> 26); h0 = Limb(d0) & mask;
+            d1 += c; c = Limb(d1 >> 26); h1 = Limb(d1) & mask;
+            d2 += c; c = Limb(d2 >> 26); h2 = Limb(d2) & mask;
+            d3 += c; c = Limb(d3 >> 26); h3 = Limb(d3) & mask;
+            d4 += c; c = Limb(d4 >> 26); h4 = Limb(d4) & mask;
+            h0 += c * 5; c = h0 >> 26; h0 &= mask;
+            h1 += c;
+        }
+
+        _h[0] = h0; _h[1] = h1; _h[2] = h2; _h[3] = h3; _h[4] = h4;
+    }
+
+    // out = (h % (2^130 - 5) + s) % 2^128
+    void tag(unsigned char out[TAG_SIZE]) {
+        const Limb mask = 0x3ffffff;
+        Limb h0 = _h[0], h1 = _h[1], h2 = _h[2], h3 = _h[3], h4 = _h[4];
+
+        Limb c = h1 >> 26; h1 &= mask;
+        h2 += c; c = h2 >> 26; h2 &= mask;
+        h3 += c; c = h3 >> 26; h3 &= mask;
+        h4 += c; c = h4 >> 26; h4 &= mask;
+        h0 += c * 5; c = h0 >> 26; h0 &= mask;
+        h1 += c;
+
+        // g = h - (2^130 - 5), taken instead of h if it does not borrow
+        Limb g0 = h0 + 5; c = g0 >> 26; g0 &= mask;
+        Limb g1 = h1 + c; c = g1 >> 26; g1 &= mask;
+        Limb g2 = h2 + c; c = g2 >> 26; g2 &= mask;
+        Limb g3 = h3 + c; c = g3 >> 26; g3 &= mask;
+        Limb g4 = h4 + c - (1 << 26);
+        Limb select = (g4 >> 31) - 1;
+        h0 = (h0 & ~select) | (g0 & select);
+        h1 = (h1 & ~select) | (g1 & select);
+        h2 = (h2 & ~select) | (g2 & select);
+        h3 = (h3 & ~select) | (g3 & select);
+        h4 = (h4 & ~select) | (g4 & select);
+
+        // Back to 4 x 32 bits, plus s
+        h0 = h0 | (h1 << 26);
+        h1 = (h1 >> 6) | (h2 << 20);
+        h2 = (h2 >> 12) | (h3 << 14);
+        h3 = (h3 >> 18) | (h4 << 8);
+
+        Double_Limb f = Double_Limb(h0) + load32(_s); store32(out, f);
+        f = Double_Limb(h1) + load32(_s + 4) + (f >> 32); store32(out + 4, f);
+        f = Double_Limb(h2) + load32(_s + 8) + (f >> 32); store32(out + 8, f);
+        f = Double_Limb(h3) + load32(_s + 12) + (f >> 32); store32(out + 12, f);
     }
+#endif
 
-    Bignum _k;
-    Bignum _r;
+private:
+    Cipher _cipher;
+    unsigned char _k[KEY_SIZE];
+    Limb _r[LIMBS];
+    Limb _h[LIMBS];
+    unsigned char _s[BLOCK_SIZE];               // the encrypted nonce
+    unsigned char _buffer[BLOCK_SIZE];          // a partial block kept between updates
+    unsigned int _buffered;
 };
 
 __END_UTIL
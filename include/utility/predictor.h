@@ -33,6 +33,65 @@ public:
     // History Types
     enum History_Type { TEMPORAL, ATEMPORAL };
 
+    // Arithmetic for fitting, modeling and checking Values: floating-point Values are handled in their own type, while
+    // integral ones are handled in fixed point, with FRACTION fractional bits in the widest integer available, so
+    // predictors of integral Values never touch floats on cores without an FPU (without 128-bit integers, windows must
+    // be short enough, in time and in Values, for n^2 * x * y * 2^FRACTION to fit in 64 bits). Models carry their
+    // coefficients as Parameters, which for integral Values are fixed point with PARAMETER_FRACTION fractional bits in
+    // 64 bits whatever the node, so a model evaluates the same at the node that fitted it and at the ones it is sent to.
+    template<typename Value, bool FLOATING = (Value(1) / Value(2) != Value(0))>
+    struct Arithmetic
+    {
+        typedef Value Sum;
+        typedef Value Coefficient;
+
+        static const bool EXACT = false;
+
+        static Coefficient slope(const Sum & num, const Sum & den) { return num / den; }
+        static Coefficient intercept(const Sum & sy, const Coefficient & a, const Sum & sx, unsigned int n) { return (sy - a * sx) / n; }
+        static Value evaluate(const Coefficient & a, const Coefficient & b, const Sum & x) { return a * x + b; }
+        static Value value(const Coefficient & c) { return c; }
+        static Coefficient coefficient(const Value & v) { return v; }
+
+        typedef Value Parameter;
+
+        static Parameter parameter(const Coefficient & c) { return c; }
+        template<typename X>
+        static Value extrapolate(const Parameter & a, const Parameter & b, const X & x) { return a * x + b; }
+    };
+
+    template<typename Value>
+    struct Arithmetic<Value, false>
+    {
+#ifdef __SIZEOF_INT128__
+        typedef __int128 Sum;
+#else
+        typedef long long Sum;
+#endif
+        typedef Sum Coefficient; // fixed point, scaled by ONE
+
+        static const bool EXACT = true;
+        static const unsigned int FRACTION = (sizeof(Sum) > 8) ? 32 : 16;
+        static const Sum ONE = Sum(1) << FRACTION;
+
+        static Coefficient slope(const Sum & num, const Sum & den) { return num * ONE / den; }
+        static Coefficient intercept(const Sum & sy, const Coefficient & a, const Sum & sx, unsigned int n) { return (sy * ONE - a * sx) / n; }
+        static Value evaluate(const Coefficient & a, const Coefficient & b, const Sum & x) { return value(a * x + b); }
+        static Value value(const Coefficient & c) { return (c + ONE / 2) >> FRACTION; }
+        static Coefficient coefficient(const Value & v) { return Sum(v) * ONE; }
+
+        typedef long long Parameter; // fixed point, scaled by 2^PARAMETER_FRACTION
+
+        static const unsigned int PARAMETER_FRACTION = 16;
+        static const unsigned int DROP = FRACTION - PARAMETER_FRACTION;
+
+        static Parameter parameter(const Coefficient & c) { return DROP ? (c + (Sum(1) << (DROP ? DROP - 1 : 0))) >> DROP : c; }
+        template<typename X>
+        static Value extrapolate(const Parameter & a, const Parameter & b, const X & x) {
+            return (a * static_cast<long long>(x) + b + (1LL << (PARAMETER_FRACTION - 1))) >> PARAMETER_FRACTION;
+        }
+    };
+
     // Predictor Models
     template<typename Time, typename Value>
     class Constant
@@ -40,7 +99,11 @@ public:
     public:
         Constant(const Value & v = 0) : _value(v) {}
 
-        Value operator()(const Time & t) { return _value; }
+        Value operator()(const Time & t) const { return _value; }
+        void operator()(const Time * t, Value * v, unsigned int n) const {
+            for(unsigned int i = 0; i < n; i++)
+                v[i] = _value;
+        }
 
         Value value() const { return _value; }
         void value(const Value & v)  { _value = v; }
@@ -49,24 +112,40 @@ public:
         Value _value;
     } __attribute__((packed));
 
+    // Coefficients are Arithmetic<Value>::Parameters (i.e. in fixed point for integral Values)
     template<typename Time, typename Value>
     class Linear
     {
+    private:
+        typedef Arithmetic<Value> Arith;
+
     public:
-        Linear(const Value & a = 0, const Value & b = 0, const Time & t0 = 0): _a(a), _b(b), _t0(t0) {}
+        typedef typename Arith::Parameter Parameter;
 
-        Value operator()(const Time & t1) { return (_a * (t1 - _t0) + _b); }
+    public:
+        Linear(const Parameter & a = 0, const Parameter & b = 0, const Time & t0 = 0): _a(a), _b(b), _t0(t0) {}
 
-        Value a() const { return _a; }
-        void a(const Value & a)  { _a = a; }
-        Value b() const { return _b; }
-        void b(const Value & b) { _b = b; }
+        Value operator()(const Time & t1) const { return Arith::extrapolate(_a, _b, t1 - _t0); }
+
+        // Batch prediction: copies of the coefficients stay in registers and the loop has no dependencies between
+        // iterations, so the compiler can vectorize it
+        void operator()(const Time * t, Value * v, unsigned int n) const {
+            const Parameter a = _a, b = _b;
+            const Time t0 = _t0;
+            for(unsigned int i = 0; i < n; i++)
+                v[i] = Arith::extrapolate(a, b, t[i] - t0);
+        }
+
+        Parameter a() const { return _a; }
+        void a(const Parameter & a)  { _a = a; }
+        Parameter b() const { return _b; }
+        void b(const Parameter & b) { _b = b; }
         Time t0() const { return _t0; }
         void t0(const Time & t0) { _t0 = t0; }
 
     private:
-        Value _a;
-        Value _b;
+        Parameter _a;
+        Parameter _b;
         Time _t0;
     } __attribute__((packed));
 
@@ -161,6 +240,184 @@ public:
     class History: public Circular_Buffer<Record<TYPE, Tn ...>, SIZE> {};
 
 
+    // Whether a prediction is within the configured relative (in %) or absolute error of the real value
+    template<typename Value, typename Config>
+    static bool acceptable(const Value & real, const Value & predicted, const Config & c) {
+        typedef typename Arithmetic<Value>::Sum Sum;
+
+        Sum error = Sum(real) - Sum(predicted);
+        Sum relative = Sum(real) * Sum(c.relative_error) / 100;
+        if(error < 0)
+            error = -error;
+        if(relative < 0)
+            relative = -relative;
+
+        return (error <= relative) || (error <= Sum(c.absolute_error));
+    }
+
+
+    // Least-squares line over a sliding window of up to SIZE temporal Records
+    // The sums of x, y, x^2 and xy are updated as Records enter and leave the window, so fitting costs the same no
+    // matter how long the window is. x is measured from the oldest Record's time, and the sums are shifted whenever
+    // that Record leaves, keeping them small. With floating-point Values, the rounding errors that adding and
+    // subtracting leave behind are discarded by summing the window again once every SIZE insertions.
+    template<typename Time, typename Value, unsigned int SIZE>
+    class Regression
+    {
+    private:
+        typedef Arithmetic<Value> Arith;
+        typedef typename Arith::Sum Sum;
+        typedef typename Arith::Coefficient Coefficient;
+
+    public:
+        typedef Record<TEMPORAL, Time, Value> Element;
+
+    public:
+        Regression(unsigned int window = SIZE) { reset(); this->window(window); }
+
+        void reset() {
+            _head = 0;
+            _size = 0;
+            _insertions = 0;
+            _origin = 0;
+            _sx = _sy = _sxx = _sxy = 0;
+            _a = _b = 0;
+            _t0 = 0;
+        }
+
+        unsigned int window() const { return _window; }
+        void window(unsigned int w) {
+            _window = ((w == 0) || (w > SIZE)) ? SIZE : w;
+            while(_size > _window)
+                pop();
+        }
+
+        bool empty() const { return !_size; }
+        bool full() const { return _size == _window; }
+        unsigned int size() const { return _size; }
+
+        // Oldest first
+        const Element & operator[](unsigned int i) const { return _records[(_head + i) % SIZE]; }
+
+        void insert(const Time & t, const Value & v) {
+            if(full())
+                pop();
+
+            if(empty())
+                _origin = t;
+            _records[(_head + _size) % SIZE] = Element(t, v);
+            _size++;
+            add(offset(t), v);
+
+            if(!Arith::EXACT && (++_insertions == SIZE)) {
+                _insertions = 0;
+                resum();
+            }
+        }
+
+        // Returns false (and a horizontal line through the average) while the window has no two distinct times
+        bool fit() {
+            _t0 = _origin;
+            if(empty()) {
+                _a = _b = 0;
+                return false;
+            }
+
+            Sum n = _size;
+            Sum den = n * _sxx - _sx * _sx;
+            if(den == 0) {
+                _a = 0;
+                _b = Arith::intercept(_sy, 0, _sx, _size);
+                return false;
+            }
+
+            _a = Arith::slope(n * _sxy - _sx * _sy, den);
+            _b = Arith::intercept(_sy, _a, _sx, _size);
+            return true;
+        }
+
+        // Of the last fit, with the coefficients as fitted (in fixed point for integral Values), even after the window
+        // has moved on
+        Value predict(const Time & t) const { return Arith::evaluate(_a, _b, offset(t, _t0)); }
+        void predict(const Time * t, Value * v, unsigned int n) const {
+            const Coefficient a = _a, b = _b;
+            const Time t0 = _t0;
+            for(unsigned int i = 0; i < n; i++)
+                v[i] = Arith::evaluate(a, b, offset(t[i], t0));
+        }
+
+        // Shifts the last fit to pass through (t, v)
+        void anchor(const Time & t, const Value & v) { _b = Arith::coefficient(v) - _a * offset(t, _t0); }
+
+        // Copies the last fit into a Linear model (integral Values get their coefficients rounded to the model's
+        // fixed point)
+        template<typename Model>
+        void model(Model & m) const {
+            m.a(Arith::parameter(_a));
+            m.b(Arith::parameter(_b));
+            m.t0(_t0);
+        }
+
+    private:
+        static Sum offset(const Time & t, const Time & origin) { return (t < origin) ? -Sum(origin - t) : Sum(t - origin); }
+        Sum offset(const Time & t) const { return offset(t, _origin); }
+
+        void add(const Sum & x, const Value & v) {
+            Sum y = v;
+            _sx += x;
+            _sy += y;
+            _sxx += x * x;
+            _sxy += x * y;
+        }
+
+        void pop() {
+            const Element & oldest = _records[_head];
+            Sum x = offset(oldest.time());
+            Sum y = oldest.value();
+            _sx -= x;
+            _sy -= y;
+            _sxx -= x * x;
+            _sxy -= x * y;
+
+            _head = (_head + 1) % SIZE;
+            _size--;
+
+            if(!empty()) {
+                // Move x's origin to the new oldest Record: (x - d)^2 = x^2 - 2xd + d^2 and (x - d)y = xy - dy
+                Time t = _records[_head].time();
+                Sum d = offset(t);
+                Sum n = _size;
+                _sxx -= 2 * d * _sx - n * d * d;
+                _sxy -= d * _sy;
+                _sx -= n * d;
+                _origin = t;
+            }
+        }
+
+        void resum() {
+            _origin = _records[_head].time();
+            _sx = _sy = _sxx = _sxy = 0;
+            for(unsigned int i = 0; i < _size; i++)
+                add(offset((*this)[i].time()), (*this)[i].value());
+        }
+
+    private:
+        Element _records[SIZE];
+        unsigned int _head;
+        unsigned int _size;
+        unsigned int _window;
+        unsigned int _insertions;
+        Time _origin;
+        Sum _sx;
+        Sum _sy;
+        Sum _sxx;
+        Sum _sxy;
+        Coefficient _a;
+        Coefficient _b;
+        Time _t0; // _origin when last fitted
+    };
+
+
 //protected:
 //    Predictor_Common(const unsigned char & type): _type(type) {}
 //
@@ -181,7 +438,7 @@ public:
     template<typename ... Tn>
     Model(const Predictor_Type & type, Tn ... an): _type(type), _id(0) {}
 
-    int operator()(const int & t) { assert(false); return 0; }
+    int operator()(const int & t) const { assert(false); return 0; }
 
     unsigned char type() const { return _type; }
     unsigned char id() const { return _id; }
@@ -208,6 +465,10 @@ public:
     Dummy_Predictor(const Configuration & c, bool r): _model(TYPE) {}
 
     Value predict(const Time & time) const { return 0; }
+    void predict(const Time * t, Value * v, unsigned int n) const {
+        for(unsigned int i = 0; i < n; i++)
+            v[i] = 0;
+    }
 
     template<typename Config>
     void configure(const Config & conf) {}
@@ -249,12 +510,12 @@ public:
     } __attribute__((packed));
 
 public:
-    LVP(Value r = 0, Value a = 0, Time t = 0): _config(r, a, t), _miss_predicted(0) {
+    LVP(Value r = 0, Value a = 0, Time t = 0): _config(r, a, t), _model(Predictor_Common::LVP), _miss_predicted(0) {
         db<Predictors>(TRC) << "LVP(r=" << r << ",a=" << a << ",t=" << t << ")" << endl;
         db<Predictors>(INF) << "LVP:config=" << _config << ",model=" << _model << ")" << endl;
     }
 
-    LVP(const Configuration & c, bool r = false): _config(c), _miss_predicted(0) {
+    LVP(const Configuration & c, bool r = false): _config(c), _model(Predictor_Common::LVP), _miss_predicted(0) {
         db<Predictors>(TRC) << "LVP(c=" << c << ",r=" << r << ")" << endl;
         db<Predictors>(INF) << "LVP:config=" << _config << ",model=" << _model << ")" << endl;
     }
@@ -264,18 +525,18 @@ public:
         return _model(t, an...);
     }
 
+    void predict(const Time * t, Value * v, unsigned int n) const { _model(t, v, n); }
+
     bool trickle(const Time & time, const Value & value) {
         db<Predictors>(TRC) << "LVP::trickle(t=" << time << ",v=" << value << ",t=" << time << ")" << endl;
 
-        float predicted = predict(time);
-        float max_acceptable_error = Math::max(Math::abs(((float)value * (float)_config.relative_error)/100.0f), (float)_config.absolute_error);
-        float error = Math::abs((float)value - predicted);
+        Value predicted = predict(time);
 
-        db<Predictors>(TRC) << "LVP::trickle:real=" << value << ",pred=" << predicted << ",err=" << error << ",max=" << max_acceptable_error << ",t_err:" << _config.time_error << ",miss:" << _miss_predicted << ")" << endl;
+        db<Predictors>(TRC) << "LVP::trickle:real=" << value << ",pred=" << predicted << ",t_err:" << _config.time_error << ",miss:" << _miss_predicted << ")" << endl;
 
-        if(error > max_acceptable_error) {
+        if(!acceptable(value, predicted, _config)) {
             if(++_miss_predicted > _config.time_error) {
-                _model->value(value);
+                _model.value(value);
                 _miss_predicted = 0;
                 return false;
             }
@@ -311,6 +572,10 @@ private:
 
 
 // Derivative-based Predictor (DBP)
+// Fits a line to the last window_size samples by least squares, kept up to date by a Regression as samples arrive, so
+// rebuilding the model costs the same regardless of the window. Predictions always come from the Linear model, which is
+// what gets sent elsewhere, so a sink given that model predicts exactly what this predictor does (with integral
+// Values, the model keeps the slope's fractional part in fixed point).
 template<typename Time, typename Value>
 class DBP: public Predictor_Common
 {
@@ -338,17 +603,17 @@ public:
         Value relative_error;
         Value absolute_error;
         Time time_error;
-        unsigned int window_size;
-        unsigned int points;
+        unsigned int window_size;       // samples fitted (0 or more than MAX_WINDOW means MAX_WINDOW)
+        unsigned int points;            // kept for compatibility with older configurations; the fit uses the whole window
     } __attribute__((packed));
 
 public:
-    DBP(unsigned int w, unsigned int p, Value r = 0, Value a = 0, Time t = 0): _ready(false), _config(w, p, r, a, t), _miss_predicted(0) {
+    DBP(unsigned int w, unsigned int p, Value r = 0, Value a = 0, Time t = 0): _ready(false), _miss_predicted(0), _config(r, a, t, w, p), _model(Predictor_Common::DBP), _history(w) {
         db<Predictors>(TRC) << "DBP(r=" << r << ",a=" << a << ",t=" << t << ")" << endl;
         db<Predictors>(INF) << "DBP:config=" << _config << ",model=" << _model << ")" << endl;
     }
 
-    DBP(const Configuration & c, bool r = false): _ready(false), _config(c), _miss_predicted(0) {
+    DBP(const Configuration & c, bool r = false): _ready(false), _miss_predicted(0), _config(c), _model(Predictor_Common::DBP), _history(c.window_size) {
         db<Predictors>(TRC) << "DBP(c=" << c << ",r=" << r << ")" << endl;
         db<Predictors>(INF) << "DBP:config=" << _config << ",model=" << _model << ")" << endl;
     }
@@ -358,30 +623,35 @@ public:
         if(_ready)
             return _model(t, an ...);
         else if(!_history.empty())
-            return _history->tail().value();
+            return _history[_history.size() - 1].value();
         else
             return 0;
     }
 
+    void predict(const Time * t, Value * v, unsigned int n) const {
+        if(_ready)
+            _model(t, v, n);
+        else
+            for(unsigned int i = 0; i < n; i++)
+                v[i] = predict(t[i]);
+    }
+
     void update(const Time & t, const Value & v) { _history.insert(t, v); }
 
     bool trickle(const Time & time, const Value & value) {
         update(time, value);
 
-        if(!_model) {
+        if(!_ready) {
             if(_history.full()){
                 build_model(time, value);
                 return false;
             }
         } else {
-            float predicted = predict(time);
-            OStream cout;
-            float max_acceptable_error = Math::max(Math::abs(((float)value * (float)_config.relative_error)/100.0f), (float)_config.absolute_error);
-            float error = Math::abs((float)value - predicted);
+            Value predicted = predict(time);
 
-            db<Predictors>(TRC) << "LVP::trickle:real=" << value << ",pred=" << predicted << ",err=" << error << ",max=" << max_acceptable_error << ",t_err:" << _config.time_error << ",miss:" << _miss_predicted << ")" << endl;
+            db<Predictors>(TRC) << "DBP::trickle:real=" << value << ",pred=" << predicted << ",t_err:" << _config.time_error << ",miss:" << _miss_predicted << ")" << endl;
 
-            if(error > max_acceptable_error) {
+            if(!acceptable(value, predicted, _config)) {
                 if(++_miss_predicted > _config.time_error) {
                     build_model(time, value);
                     _miss_predicted = 0;
@@ -398,43 +668,26 @@ public:
     const Model & model() const { return _model; }
     void model(const Model & m) { _model = m; }
 
-    void update(const Model & m, const bool & from_sink) { _model = m; }
+    void update(const Model & m, const bool & from_sink) { _model = m; _ready = true; }
 
     template<typename Config>
     void configure(const Config & c) {
+        _config.window_size = c.window_size;
         _config.points = c.points;
         _config.relative_error = c.relative_error;
         _config.absolute_error = c.absolute_error;
         _config.time_error = c.time_error;
+        _history.window(c.window_size);
     }
 
 protected:
-    void build_model(const Time & t, const Value & v){
+    void build_model(const Time & t, const Value & v) {
         assert(_history.full());
 
-        float avg_oldest = 0;
-        float avg_recent = 0;
-
-        _model.t0(_history[0].time());
-
-        for(unsigned int i = 0; i < _config.points; i++)
-            avg_oldest += _history[i].value();
-        avg_oldest /= _config.points;
-
-        for(unsigned int i = 0; i < _config.point; i++)
-            avg_recent += _history[_history.size() -1 - i].value();
-        avg_recent /= _config.points;
-
-        float t_oldest = (_history[0].time() + _history[_config.points - 1].time()) / 2;
-        float t_recent = (_history[_history.size() - 1].time() + _history[_history.size() -1 - (_config.point - 1)].time()) / 2;
-
-        _model.a((avg_recent - avg_oldest) / (t_recent - t_oldest));
-        _model.b(avg_oldest);
-        _model.t0(t_oldest);
-
-        float predicted = predict(t);
-        float error = v - predicted;
-        _model.b(avg_oldest + error);
+        // Anchor the line at the sample that triggered the rebuild
+        _history.fit();
+        _history.anchor(t, v);
+        _history.model(_model);
         _ready = true;
     }
 
@@ -444,7 +697,7 @@ private:
 
     Configuration _config;
     Model _model;
-    History<TEMPORAL, MAX_WINDOW, Time, Value> _history;
+    Regression<Time, Value, MAX_WINDOW> _history;
 };
 
 template<Predictor_Common::Predictor_Type TYPE>
@@ -84,11 +84,12 @@ template<typename T,
 class Queue: public Queue_Wrapper<List<T, El>, false> {};
 
 
-// Ordered Queue
+// Ordered Queue (L = Ordered_Tree, with El = List_Elements::Doubly_Linked_Tree, for O(log n) insertions)
 template<typename T,
           typename R = List_Element_Rank,
-          typename El = List_Elements::Doubly_Linked_Ordered<T, R> >
-class Ordered_Queue: public Queue_Wrapper<Ordered_List<T, R, El>, false> {};
+          typename El = List_Elements::Doubly_Linked_Ordered<T, R>,
+          typename L = Ordered_List<T, R, El> >
+class Ordered_Queue: public Queue_Wrapper<L, false> {};
 
 
 // Relatively-Ordered Queue
@@ -1,36 +1,129 @@
 // EPOS Pseudo Random Number Generator Utility Declarations
 
-// From http://en.wikipedia.org/wiki/Linear_congruential_generator
-// with A = 2 and variable C on a simplification of:
-// X1 = aX0 + c
-// as X1 = (X0 << 1) xor C
+// xoshiro256** from http://prng.di.unimi.it (Blackman and Vigna, "Scrambled Linear Pseudorandom Number Generators"):
+// 256 bits of state updated with shifts, rotations and XORs, with a period of 2^256 - 1, 64-bit outputs and jump()
+// to advance 2^128 steps at once, which splits the sequence into independent streams.
+// Each CPU has a generator of its own, in a cache line of its own, so no locks or atomic operations are needed (a thread
+// preempted in the middle of an update only weakens the sequence of that CPU). Seeds are expanded into the state with
+// SplitMix64 and every CPU's stream is then jumped by its id, so CPUs seeded alike still get disjoint sequences.
 
 #ifndef __random_h
 #define __random_h
 
-#include <system/config.h>
+#include <architecture.h>
 
 __BEGIN_UTIL
 
 class Random
 {
-private:
-    static const unsigned long A = 1103515245;
-    static const unsigned long C = 12345;
-    static const unsigned long M = 4294967295U;
+public:
+    typedef unsigned long long Value;
+
+    class Generator
+    {
+    private:
+        static const unsigned int LINE = Traits<CPU>::CACHE_LINE_SIZE;
+
+    public:
+        constexpr Generator(Value seed = 0): _s() { expand(seed); }
+
+        void seed(Value value, unsigned int stream = 0) {
+            expand(value);
+            for(unsigned int i = 0; i < stream; i++)
+                jump();
+        }
+
+        Value next() {
+            Value result = rotl(_s[1] * 5, 7) * 9;
+            Value t = _s[1] << 17;
+
+            _s[2] ^= _s[0];
+            _s[3] ^= _s[1];
+            _s[1] ^= _s[2];
+            _s[0] ^= _s[3];
+            _s[2] ^= t;
+            _s[3] = rotl(_s[3], 45);
+
+            return result;
+        }
+
+        // Equivalent to 2^128 calls to next()
+        void jump() {
+            static const Value JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+            Value s[4] = { 0, 0, 0, 0 };
+            for(unsigned int i = 0; i < 4; i++)
+                for(unsigned int b = 0; b < 64; b++) {
+                    if(JUMP[i] & (1ULL << b))
+                        for(unsigned int j = 0; j < 4; j++)
+                            s[j] ^= _s[j];
+                    next();
+                }
+            for(unsigned int j = 0; j < 4; j++)
+                _s[j] = s[j];
+        }
+
+        // Uniform in [0, n), by multiplying instead of dividing (Lemire, "Fast Random Integer Generation in an Interval");
+        // the few products that would bias the result are rejected, and the modulo that finds them is only computed
+        // when a product falls close enough to need it
+        unsigned int range(unsigned int n) {
+            Value m = (next() >> 32) * n;
+            if(static_cast<unsigned int>(m) < n) {
+                unsigned int threshold = -n % n;
+                while(static_cast<unsigned int>(m) < threshold)
+                    m = (next() >> 32) * n;
+            }
+            return m >> 32;
+        }
+
+        // Uniform in [min, max], with the span taken in unsigned arithmetic (it wraps to 0 only for the full int range)
+        int range(int min, int max) {
+            unsigned int n = static_cast<unsigned int>(max) - static_cast<unsigned int>(min) + 1;
+            unsigned int r = n ? range(n) : static_cast<unsigned int>(next() >> 32);
+            return static_cast<int>(static_cast<unsigned int>(min) + r);
+        }
+
+        void fill(void * buffer, unsigned long size) {
+            unsigned char * b = reinterpret_cast<unsigned char *>(buffer);
+            for(; size >= sizeof(Value); size -= sizeof(Value)) {
+                Value v = next();
+                for(unsigned int i = 0; i < sizeof(Value); i++, v >>= 8)
+                    *b++ = v;
+            }
+            if(size)
+                for(Value v = next(); size; size--, v >>= 8)
+                    *b++ = v;
+        }
+
+    private:
+        constexpr void expand(Value seed) {
+            for(unsigned int i = 0; i < 4; i++) {
+                Value z = (seed += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                _s[i] = z ^ (z >> 31);
+            }
+        }
+
+        static constexpr Value rotl(Value x, unsigned int k) { return (x << k) | (x >> (64 - k)); }
+
+    private:
+        Value _s[4] __attribute__((aligned(LINE)));
+    };
 
 public:
-    static int random() {
-        _seed = ((_seed * A) + C) % M; //_seed = (_seed << 1) ^ n;
-        return _seed;
-    }
+    static int random() { return generator().next() >> 33; }
+    static unsigned int range(unsigned int n) { return generator().range(n); }
+    static int range(int min, int max) { return generator().range(min, max); }
+    static void fill(void * buffer, unsigned long size) { generator().fill(buffer, size); }
+
+    // Seeds the running CPU's generator
+    static void seed(Value value) { generator().seed(value, CPU::id()); }
 
-    static void seed(int value) {
-        _seed = value;
-    }
+    static Generator & generator() { return _generators[CPU::id()]; }
 
 private:
-    static int _seed;
+    static Generator _generators[Traits<Build>::CPUS];
 };
 
 __END_UTIL
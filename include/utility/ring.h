@@ -0,0 +1,267 @@
+// EPOS Lock-free Ring Buffer Utility Declarations
+
+#ifndef __ring_h
+#define __ring_h
+
+#include <architecture.h>
+
+__BEGIN_UTIL
+
+// Lock-free bounded rings of N (a power of two) items of type T, for handing data over between threads, possibly on
+// different CPUs, without Semaphores. insert() and remove() return false instead of waiting when the ring is full or
+// empty, respectively. Read and write indices grow freely (positions are taken modulo N) and are kept in separate
+// cache lines, so producers and consumers don't invalidate each other's lines on every operation.
+
+// Single-Producer/Single-Consumer Ring
+// Each side only writes its own index, so ordering relies on memory fences alone. Each side also keeps a private copy
+// of the other's index and only rereads it when the copy says the ring is full (or empty).
+template<typename T, unsigned int N>
+class SPSC_Ring
+{
+private:
+    static const unsigned int LINE = Traits<CPU>::CACHE_LINE_SIZE;
+
+public:
+    typedef T Object_Type;
+
+public:
+    SPSC_Ring(): _head(0), _tail_copy(0), _tail(0), _head_copy(0) {
+        static_assert(N && !(N & (N - 1)), "SPSC_Ring size must be a power of two!");
+    }
+
+    bool insert(const T & item) {
+        T * slot = reserve();
+        if(!slot)
+            return false;
+        *slot = item;
+        publish();
+        return true;
+    }
+
+    bool remove(T * item) {
+        const T * slot = peek();
+        if(!slot)
+            return false;
+        *item = *slot;
+        consume();
+        return true;
+    }
+
+    // Zero-copy interface: the slot returned by reserve() (or 0 if the ring is full) is filled in place and handed to
+    // the consumer by publish(); the one returned by peek() (or 0 if the ring is empty) is read in place and given back
+    // to the producer by consume()
+    T * reserve() {
+        unsigned long tail = _tail;
+        if(tail - _head_copy == N) {
+            _head_copy = _head;
+            if(tail - _head_copy == N)
+                return 0;
+        }
+        CPU::fence(); // the consumer is done with the slot
+        return &_items[tail % N];
+    }
+
+    void publish() {
+        CPU::fence(); // the item must be complete before it is handed over
+        _tail = _tail + 1;
+    }
+
+    const T * peek() {
+        unsigned long head = _head;
+        if(head == _tail_copy) {
+            _tail_copy = _tail;
+            if(head == _tail_copy)
+                return 0;
+        }
+        CPU::fence(); // don't read the item before the index that published it
+        return &_items[head % N];
+    }
+
+    void consume() {
+        CPU::fence(); // the item must be read before the slot is given back
+        _head = _head + 1;
+    }
+
+    bool empty() const { return _head == _tail; }
+    bool full() const { return _tail - _head == N; }
+    unsigned long size() const { return _tail - _head; }
+
+private:
+    volatile unsigned long _head __attribute__((aligned(LINE)));    // next position to be read (written by the consumer)
+    unsigned long _tail_copy;                                       // the consumer's copy of _tail
+    volatile unsigned long _tail __attribute__((aligned(LINE)));    // next position to be written (written by the producer)
+    unsigned long _head_copy;                                       // the producer's copy of _head
+    T _items[N] __attribute__((aligned(LINE)));
+};
+
+
+// Multiple-Producer/Multiple-Consumer Ring
+// After Dmitry Vyukov's bounded MPMC queue: each slot carries a sequence number telling whether it is ready to be
+// written (position) or read (position + 1) in the current lap, and positions are claimed by advancing the indices with
+// CPU::cas(). Producers and consumers then fill and empty their slots concurrently.
+template<typename T, unsigned int N>
+class MPMC_Ring
+{
+private:
+    static const unsigned int LINE = Traits<CPU>::CACHE_LINE_SIZE;
+
+    struct Slot {
+        volatile unsigned long sequence; // position + 1 once written, position + N once read
+        T item;
+    };
+
+public:
+    typedef T Object_Type;
+
+public:
+    MPMC_Ring(): _head(0), _tail(0) {
+        static_assert(N && !(N & (N - 1)), "MPMC_Ring size must be a power of two!");
+
+        for(unsigned int i = 0; i < N; i++)
+            _slots[i].sequence = i;
+    }
+
+    bool insert(const T & item) {
+        unsigned long pos;
+        Slot * s = claim(_tail, pos, 0);
+        if(!s)
+            return false;
+        s->item = item;
+        release(s, pos + 1);
+        return true;
+    }
+
+    bool remove(T * item) {
+        unsigned long pos;
+        Slot * s = claim(_head, pos, 1);
+        if(!s)
+            return false;
+        *item = s->item;
+        release(s, pos + N);
+        return true;
+    }
+
+    bool empty() const { return _head == _tail; }                   // approximate while others operate
+    unsigned long size() const { return _tail - _head; }            // approximate while others operate
+
+private:
+    // Claims the slot at index, if it is ready (ready = 0 for writers, 1 for readers)
+    Slot * claim(volatile unsigned long & index, unsigned long & pos, unsigned long ready) {
+        pos = index;
+        for(;;) {
+            Slot * s = &_slots[pos % N];
+            long diff = static_cast<long>(s->sequence - (pos + ready));
+            if(diff == 0) {
+                unsigned long old = CPU::cas(index, pos, pos + 1);
+                if(old == pos) {
+                    CPU::fence(); // don't touch the item before the slot is ours
+                    return s;
+                }
+                pos = old;
+            } else if(diff < 0)
+                return 0;
+            else
+                pos = index;
+        }
+    }
+
+    void release(Slot * s, unsigned long sequence) {
+        CPU::fence(); // the item must be complete (or read) before the slot is handed over
+        s->sequence = sequence;
+    }
+
+private:
+    volatile unsigned long _head __attribute__((aligned(LINE)));    // next position to be read
+    volatile unsigned long _tail __attribute__((aligned(LINE)));    // next position to be written
+    Slot _slots[N] __attribute__((aligned(LINE)));
+};
+
+
+// Blocking Ring
+// Adds put() and get() to a Ring, which wait on a Semaphore (a template parameter, since utilities come before the
+// synchronizers) when the Ring is full or empty. The Semaphores are only touched when someone waits: the waiting side
+// counts itself with CPU::finc() and retries before sleeping, and the other side only signals if it takes a waiter.
+template<typename Ring, typename Semaphore>
+class Blocking_Ring: public Ring
+{
+public:
+    typedef typename Ring::Object_Type Object_Type;
+
+public:
+    Blocking_Ring(): _putters(0), _getters(0), _not_full(0), _not_empty(0) {}
+
+    bool insert(const Object_Type & item) {
+        if(!Ring::insert(item))
+            return false;
+        wakeup(_getters, _not_empty);
+        return true;
+    }
+
+    bool remove(Object_Type * item) {
+        if(!Ring::remove(item))
+            return false;
+        wakeup(_putters, _not_full);
+        return true;
+    }
+
+    // Zero-copy counterparts of insert() and remove() (for Rings that have reserve() and peek(), i.e. SPSC_Ring)
+    void publish() {
+        Ring::publish();
+        wakeup(_getters, _not_empty);
+    }
+
+    void consume() {
+        Ring::consume();
+        wakeup(_putters, _not_full);
+    }
+
+    void put(const Object_Type & item) {
+        while(!insert(item))
+            if(sleep(_putters, _not_full, [&]() { return insert(item); }))
+                break;
+    }
+
+    void get(Object_Type * item) {
+        while(!remove(item))
+            if(sleep(_getters, _not_empty, [&]() { return remove(item); }))
+                break;
+    }
+
+private:
+    // Returns whether the retry succeeded
+    template<typename Retry>
+    bool sleep(volatile long & waiters, Semaphore & semaphore, Retry retry) {
+        CPU::finc(waiters);
+        CPU::fence();
+        if(retry()) {
+            if(!take(waiters)) // someone has already signaled on our behalf, so consume it
+                semaphore.p();
+            return true;
+        }
+        semaphore.p();
+        return false;
+    }
+
+    void wakeup(volatile long & waiters, Semaphore & semaphore) {
+        CPU::fence(); // waiters must only be checked after the ring has changed
+        if(take(waiters))
+            semaphore.v();
+    }
+
+    static bool take(volatile long & waiters) {
+        for(long n = waiters; n > 0; n = waiters)
+            if(CPU::cas(waiters, n, n - 1) == n)
+                return true;
+        return false;
+    }
+
+private:
+    volatile long _putters;     // blocked (or about to) on _not_full
+    volatile long _getters;     // blocked (or about to) on _not_empty
+    Semaphore _not_full;
+    Semaphore _not_empty;
+};
+
+__END_UTIL
+
+#endif
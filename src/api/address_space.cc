@@ -19,6 +19,13 @@ Address_Space::~Address_Space()
     db<Address_Space>(TRC) << "~Address_Space(this=" << this << ") [Directory::pd=" << Directory::pd() << "]" << endl;
 }
 
+void Address_Space::activate()
+{
+    db<Address_Space>(TRC) << "Address_Space::activate(this=" << this << ") [Directory::pd=" << Directory::pd() << "]" << endl;
+
+    Directory::activate();
+}
+
 Address_Space::Log_Addr Address_Space::attach(Segment * seg)
 {
     Log_Addr tmp = Directory::attach(*seg);
@@ -7,9 +7,9 @@
 
 __BEGIN_SYS
 
-Alarm_Timer * Alarm::_timer;
-volatile Alarm::Tick Alarm::_elapsed;
-Alarm::Queue Alarm::_request;
+Alarm_Timer * Alarm::_timer __SCRATCHPAD_DATA;
+volatile Alarm::Tick Alarm::_elapsed __SCRATCHPAD_DATA;
+Alarm::Queue Alarm::_request __SCRATCHPAD_DATA;
 
 Alarm::Alarm(const Microsecond & time, Handler * handler, unsigned int times)
 : _time(time), _handler(handler), _times(times), _ticks(ticks(time)), _link(this, _ticks)
@@ -0,0 +1,97 @@
+// EPOS Monitor Component Implementation
+
+#include <monitor.h>
+#include <time.h>
+
+__BEGIN_SYS
+
+constexpr System_Event Traits<Monitor>::SYSTEM_EVENTS[];
+constexpr PMU_Event Traits<Monitor>::PMU_EVENTS[];
+
+Monitor::Sample * Monitor::_buffer[CPUS];
+volatile unsigned long Monitor::_head[CPUS];
+volatile unsigned long Monitor::_skipped[CPUS];
+Monitor::Time_Stamp Monitor::_cost[CPUS];
+Monitor::Time_Stamp Monitor::_start[CPUS];
+Monitor::Time_Stamp Monitor::_busy[CPUS];
+Monitor::Time_Stamp Monitor::_last_dispatch[CPUS];
+Thread * volatile Monitor::_preempted[CPUS];
+
+Clerk<System>::Data Clerk<System>::read() const
+{
+    unsigned int cpu = CPU::id();
+    Thread * thread = Monitor::_preempted[cpu];
+
+    switch(_event) {
+    case ELAPSED_TIME:
+        return Alarm::time(Alarm::elapsed());
+    case DEADLINE_MISSES:
+        return Real_Time_Scheduler_Common::deadline_misses();
+    case CPU_EXECUTION_TIME:
+        return Monitor::_busy[cpu] * 1000000 / TSC::frequency();
+    case THREAD_EXECUTION_TIME:
+        return thread ? Data(Alarm::time(thread->criterion().statistics().thread_execution_time)) : 0;
+    case RUNNING_THREAD:
+        return reinterpret_cast<unsigned long>(thread);
+    default:
+        return 0;
+    }
+}
+
+void Monitor::sample()
+{
+    // Sampling must not migrate, since both the PMU and the buffers are per-core
+    CPU::int_disable();
+
+    unsigned int cpu = CPU::id();
+    Time_Stamp begin = TSC::time_stamp();
+
+    if(_cost[cpu] * 1000000 > Time_Stamp(OVERHEAD) * (begin - _start[cpu])) {
+        _skipped[cpu]++;
+        CPU::int_enable();
+        return;
+    }
+
+    Sample & s = _buffer[cpu][_head[cpu] % SAMPLES];
+    s.time_stamp = begin;
+    for(unsigned int i = 0; i < SYSTEM_EVENTS; i++)
+        s.data[i] = Clerk<System>(Traits<Monitor>::SYSTEM_EVENTS[i]).read();
+    for(unsigned int i = 0; i < PMU_EVENTS; i++)
+        s.data[SYSTEM_EVENTS + i] = Clerk<PMU>(Traits<Monitor>::PMU_EVENTS[i], PMU::FIXED + i).read();
+    _head[cpu]++;
+
+    _cost[cpu] += TSC::time_stamp() - begin;
+
+    CPU::int_enable();
+}
+
+int Monitor::run()
+{
+    db<Monitor>(TRC) << "Monitor::run(cpu=" << CPU::id() << ")" << endl;
+
+    // Monitors exit as soon as only daemons are left besides idle, so the system can shutdown
+    while(Thread::_thread_count > CPUS + Thread::_daemon_count) {
+        Alarm::delay(1000000 / FREQUENCY);
+        sample();
+    }
+
+    return 0;
+}
+
+void Monitor::dump(OStream & os)
+{
+    // One line per sample: cpu,time_stamp,system events...,pmu events...
+    for(unsigned int cpu = 0; cpu < CPUS; cpu++) {
+        for(unsigned int i = 0; i < samples(cpu); i++) {
+            const Sample & s = sample(cpu, i);
+            os << cpu << "," << s.time_stamp;
+            for(unsigned int j = 0; j < EVENTS; j++)
+                os << "," << s.data[j];
+            os << endl;
+        }
+        if(_skipped[cpu])
+            db<Monitor>(WRN) << "Monitor::dump: " << _skipped[cpu] << " samples skipped on CPU " << cpu << " to keep overhead under " << OVERHEAD << " ppm" << endl;
+    }
+}
+
+__END_SYS
@@ -0,0 +1,29 @@
+// EPOS Monitor Initialization
+
+#include <monitor.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+void Monitor::init()
+{
+    db<Init, Monitor>(TRC) << "Monitor::init()" << endl;
+
+    // Performance counters are per-core, so every CPU configures its own
+    for(unsigned int i = 0; i < PMU_EVENTS; i++)
+        Clerk<PMU>(Traits<Monitor>::PMU_EVENTS[i], PMU::FIXED + i).setup();
+
+    _start[CPU::id()] = _last_dispatch[CPU::id()] = TSC::time_stamp();
+
+    if(CPU::id() == CPU::BSP) {
+        for(unsigned int i = 0; i < CPUS; i++)
+            _buffer[i] = new (SYSTEM) Sample[SAMPLES];
+
+        // Samplers are not pinned; under global scheduling each one samples the CPU it happens to run on
+        Thread::_daemon_count += THREADS;
+        for(unsigned int i = 0; i < THREADS; i++)
+            new (SYSTEM) Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::LOW)), &run);
+    }
+}
+
+__END_SYS
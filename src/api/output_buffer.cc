@@ -0,0 +1,147 @@
+// EPOS Output Buffer Component Implementation
+
+#include <output_buffer.h>
+#include <machine/display.h>
+#include <process.h>
+#include <time.h>
+
+__BEGIN_SYS
+
+Output_Buffer::Ring Output_Buffer::_ring[CPUS];
+volatile bool Output_Buffer::_display;
+volatile bool Output_Buffer::_synchronous;
+
+void Output_Buffer::put(const char * s)
+{
+    // Rings are per-core, so the caller must not migrate, and interrupt handlers might print too
+    bool disabled = CPU::int_disabled();
+    if(!disabled)
+        CPU::int_disable();
+
+    Ring * ring = &_ring[CPU::id()];
+    lock(ring->lock);
+    for(; *s; s++) {
+        ring->line[ring->line_size++] = *s;
+        if((*s == '\n') || (ring->line_size == LINE))
+            commit(ring);
+    }
+    unlock(ring->lock);
+
+    if(!disabled)
+        CPU::int_enable();
+}
+
+// Called with the ring locked and interrupts disabled
+void Output_Buffer::commit(Ring * ring)
+{
+    if(SIZE - (ring->head - ring->tail) < ring->line_size) {
+        // The ring is full: write it out synchronously instead of losing output
+        char buf[LINE + 1];
+        lock(_display);
+        for(unsigned int n = drain(ring, buf, LINE); n; n = drain(ring, buf, LINE)) {
+            buf[n] = 0;
+            Display::puts(buf);
+        }
+        unlock(_display);
+    }
+
+    for(unsigned int i = 0; i < ring->line_size; i++)
+        ring->data[(ring->head + i) % SIZE] = ring->line[i];
+    ring->head += ring->line_size;
+    ring->line_size = 0;
+}
+
+// Moves up to max bytes (at most one line) out of the ring, which must be locked
+unsigned int Output_Buffer::drain(Ring * ring, char * buf, unsigned int max)
+{
+    unsigned int n = 0;
+    while((n < max) && (ring->tail != ring->head)) {
+        char c = ring->data[ring->tail % SIZE];
+        ring->tail++;
+        buf[n++] = c;
+        if(c == '\n')
+            break;
+    }
+    return n;
+}
+
+// Drains one line from each ring, returning false if all of them were empty
+bool Output_Buffer::flush()
+{
+    bool drained = false;
+
+    for(unsigned int cpu = 0; cpu < CPUS; cpu++) {
+        char buf[LINE + 1];
+
+        // The Display lock is not held while the ring is, so put() never waits on the UART
+        CPU::int_disable();
+        lock(_ring[cpu].lock);
+        unsigned int n = drain(&_ring[cpu], buf, LINE);
+        unlock(_ring[cpu].lock);
+
+        if(n) {
+            buf[n] = 0;
+            lock(_display);
+            Display::puts(buf);
+            unlock(_display);
+            drained = true;
+        }
+        CPU::int_enable();
+    }
+
+    return drained;
+}
+
+void Output_Buffer::synchronize(bool panic)
+{
+    if(!buffered || _synchronous)
+        return;
+
+    _synchronous = true;
+
+    // Other CPUs might still be committing lines or draining them into the Display, so each ring is drained holding its
+    // lock and then the Display's, in the same order as commit(). A lock that cannot be taken after TRIES spins is held
+    // by a CPU that is not coming back, so it is ignored as on panic.
+    for(unsigned int cpu = 0; cpu < CPUS; cpu++) {
+        Ring * ring = &_ring[cpu];
+        char buf[LINE + 1];
+
+        bool ring_locked = !panic && try_lock(ring->lock);
+        bool display_locked = !panic && try_lock(_display);
+
+        for(unsigned int n = drain(ring, buf, LINE); n; n = drain(ring, buf, LINE)) {
+            buf[n] = 0;
+            Display::puts(buf);
+        }
+        if(ring->line_size) {
+            ring->line[ring->line_size < LINE ? ring->line_size : LINE - 1] = 0;
+            Display::puts(ring->line);
+            Display::putc('\n');
+            ring->line_size = 0;
+        }
+
+        if(display_locked)
+            unlock(_display);
+        if(ring_locked)
+            unlock(ring->lock);
+    }
+}
+
+int Output_Buffer::run()
+{
+    // The drainer exits as soon as only daemons are left besides idle, flushing whatever was left behind
+    while(Thread::_thread_count > CPUS + Thread::_daemon_count) {
+        if(!flush()) {
+            if(Traits<Alarm>::enabled)
+                Alarm::delay(PERIOD);
+            else
+                Thread::yield();
+        }
+    }
+
+    synchronize();
+
+    return 0;
+}
+
+__END_SYS
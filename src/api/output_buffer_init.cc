@@ -0,0 +1,19 @@
+// EPOS Output Buffer Initialization
+
+#include <output_buffer.h>
+#include <process.h>
+#include <system.h>
+
+__BEGIN_SYS
+
+void Output_Buffer::init()
+{
+    db<Init, OStream>(TRC) << "Output_Buffer::init()" << endl;
+
+    if(CPU::id() == CPU::BSP) {
+        Thread::_daemon_count++;
+        new (SYSTEM) Thread(Thread::Configuration(Thread::READY, Thread::Criterion(Thread::LOW)), &run);
+    }
+}
+
+__END_SYS
@@ -6,6 +6,7 @@
 __BEGIN_SYS
 
 volatile unsigned int Variable_Queue_Scheduler::_next_queue;
+volatile unsigned int Real_Time_Scheduler_Common::_deadline_misses;
 
 inline Real_Time_Scheduler_Common::Tick Real_Time_Scheduler_Common::elapsed() { return Alarm::elapsed(); }
 
@@ -20,6 +21,8 @@ void Real_Time_Scheduler_Common::collect(Event event) {
 
         _statistics.thread_creation = elapsed();
         _statistics.job_released = false;
+        _statistics.response_time_min = Tick(-1UL >> 1);
+        _statistics.start_latency_min = Tick(-1UL >> 1);
     }
     if(event & FINISH) {
         db<Thread>(TRC) << "FINISH";
@@ -31,6 +34,18 @@ void Real_Time_Scheduler_Common::collect(Event event) {
 
         _statistics.thread_last_dispatch = elapsed();
         _statistics.thread_last_dispatch_on_core[CPU::id()] = elapsed();
+
+        if(periodic() && _statistics.job_released && !_statistics.job_started) {
+            Tick latency = elapsed() - _statistics.job_release;
+
+            _statistics.job_started = true;
+            _statistics.job_start = elapsed();
+            _statistics.jobs_started++;
+            if(latency < _statistics.start_latency_min)
+                _statistics.start_latency_min = latency;
+            if(latency > _statistics.start_latency_max)
+                _statistics.start_latency_max = latency;
+        }
     }
     if(event & LEAVE) {
         Tick cpu_time = elapsed() - _statistics.thread_last_dispatch;
@@ -40,16 +55,19 @@ void Real_Time_Scheduler_Common::collect(Event event) {
 
         _statistics.thread_last_preemption = elapsed();
         _statistics.thread_execution_time += cpu_time;
-        // Para PLLF, quando a coleta acontece em uma CPU diferente de 0, é coletado a CPU 0 sempre.
-        // Testamos a quantidade de iterações nos testes, e confirmamos que a thread executa o número
-        // de iterações corretamente
         _statistics.execution_per_cpu[CPU::id()] += cpu_time_on_core;
         _statistics.job_utilization += cpu_time;
     }
     if(periodic() && (event & JOB_RELEASE)) {
         db<Thread>(TRC) << "RELEASE";
 
+        // The previous job is still pending at the release of the next one, so it has missed its deadline
+        if(_statistics.job_released && !_statistics.job_missed)
+            miss();
+
         _statistics.job_released = true;
+        _statistics.job_started = false;
+        _statistics.job_missed = false;
         _statistics.job_release = elapsed();
         _statistics.job_start = 0;
         _statistics.job_utilization = 0;
@@ -58,9 +76,18 @@ void Real_Time_Scheduler_Common::collect(Event event) {
     if(periodic() && (event & JOB_FINISH)) {
         db<Thread>(TRC) << "WAIT";
 
+        Tick response = elapsed() - _statistics.job_release;
+        if((response > _deadline) && !_statistics.job_missed)
+            miss();
+
         _statistics.job_released = false;
         _statistics.job_finish = elapsed();
         _statistics.jobs_finished++;
+        _statistics.response_time_sum += response;
+        if(response < _statistics.response_time_min)
+            _statistics.response_time_min = response;
+        if(response > _statistics.response_time_max)
+            _statistics.response_time_max = response;
     }
     if(event & COLLECT) {
         db<Thread>(TRC) << "|COLLECT";
@@ -77,6 +104,14 @@ void Real_Time_Scheduler_Common::collect(Event event) {
     db<Thread>(TRC) << ") => {i=" << _priority << ",p=" << _period << ",d=" << _deadline << ",c=" << _capacity << "}" << endl;
 }
 
+void Real_Time_Scheduler_Common::miss() {
+    db<Thread>(WRN) << "RT::miss(this=" << this << ",job=" << _statistics.jobs_released << ",release=" << _statistics.job_release << ",d=" << _deadline << ")" << endl;
+
+    _statistics.job_missed = true;
+    _statistics.deadline_misses++;
+    CPU::finc(_deadline_misses);
+}
+
 // The following Scheduling Criteria depend on Alarm, which is not available at scheduler.h
 template <typename ... Tn>
 FCFS::FCFS(int p, Tn & ... an): Priority((p == IDLE) ? IDLE : Alarm::elapsed()) {}
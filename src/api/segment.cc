@@ -4,10 +4,13 @@
 
 __BEGIN_SYS
 
+// Class attributes
+volatile unsigned int Segment::_next_color[CPUS];
+
 // Methods
-Segment::Segment(unsigned long bytes, Flags flags): Chunk(bytes, flags, WHITE)
+Segment::Segment(unsigned long bytes, Flags flags, Color color): Chunk(bytes, flags, color)
 {
-    db<Segment>(TRC) << "Segment(bytes=" << bytes << ",flags=" << flags << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
+    db<Segment>(TRC) << "Segment(bytes=" << bytes << ",flags=" << flags << ",color=" << color << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
 }
 
 
@@ -19,6 +22,13 @@ Segment::Segment(Phy_Addr phy_addr, unsigned long bytes, Flags flags): Chunk(phy
 }
 
 
+Segment::Segment(const Segment * source): Chunk(source)
+// Segments created with Flags::LZ only get frames when first touched, and clones of them stay lazy
+{
+    db<Segment>(TRC) << "Segment(source=" << source << ") [Chunk::pt=" << Chunk::pt() << ",sz=" << Chunk::size() << "] => " << this << endl;
+}
+
+
 Segment::~Segment()
 {
     db<Segment>(TRC) << "~Segment() [Chunk::pt=" << Chunk::pt() << "]" << endl;
@@ -50,4 +60,18 @@ void Segment::reflag(Flags flags)
     Chunk::reflag(flags);
 }
 
+
+Color Segment::color(unsigned int partition)
+{
+    // Colors 1 .. COLORS - 1 are dealt in contiguous ranges; CPUs get WHITE if there are not enough colors to go around
+    unsigned int colors = (COLORS - 1) / CPUS;
+    if(!colors)
+        return WHITE;
+
+    partition %= CPUS;
+    unsigned int i = CPU::finc(_next_color[partition]) % colors;
+
+    return static_cast<Color>(1 + partition * colors + i);
+}
+
 __END_SYS
@@ -0,0 +1,54 @@
+// EPOS Segment Heap Implementation
+
+#include <system.h>
+
+__BEGIN_SYS
+
+// Methods
+Segment_Heap::Segment_Heap(Address_Space * as, Segment * seg, Segment::Flags flags, Log_Addr addr)
+: Heap(&grow), _segment(seg), _pd(as->pd()), _flags(flags), _size(seg->size()), _extensions(0)
+{
+    _base = addr ? as->attach(seg, addr) : as->attach(seg);
+    if(!_base)
+        db<Heaps>(ERR) << "Segment_Heap(as=" << as << ",seg=" << seg << ",addr=" << addr << "): failed to attach segment!" << endl;
+    else
+        free(_base, seg->size());
+    _top = _base + seg->size();
+
+    db<Init, Heaps>(TRC) << "Segment_Heap(as=" << as << ",seg=" << seg << ",addr=" << addr << ") [base=" << _base << ",sz=" << seg->size() << "] => " << this << endl;
+}
+
+
+void * Segment_Heap::grow(Heap * heap, unsigned long & bytes)
+{
+    Segment_Heap * h = static_cast<Segment_Heap *>(heap);
+    Address_Space as(h->_pd);
+
+    if(!h->_base || (h->_extensions >= EXTENSIONS)) {
+        db<Heaps>(WRN) << "Segment_Heap::grow(this=" << h << "): cannot grow any further!" << endl;
+        return 0;
+    }
+
+    // Attaching starts at a page table boundary, so the new segment may leave a gap after the last one
+    Segment * seg = new (&h->_extension[h->_extensions * sizeof(Segment)]) Segment((bytes > h->_size) ? bytes : h->_size, h->_flags);
+    Log_Addr addr = as.attach(seg, MMU::align_segment(h->_top));
+    if(!addr)
+        addr = as.attach(seg);
+    if(!addr) {
+        db<Heaps>(WRN) << "Segment_Heap::grow(this=" << h << "): failed to attach a new segment!" << endl;
+        seg->~Segment();
+        return 0;
+    }
+
+    h->_extensions++;
+    h->_size += seg->size();
+    if(addr + seg->size() > h->_top)
+        h->_top = addr + seg->size();
+    bytes = seg->size();
+
+    db<Heaps>(TRC) << "Segment_Heap::grow(this=" << h << ") => {addr=" << addr << ",bytes=" << bytes << "}" << endl;
+
+    return addr;
+}
+
+__END_SYS
@@ -1,18 +1,36 @@
 // EPOS System Initialization
 
 #include <system.h>
+#include <memory.h>
 #include <time.h>
 #include <process.h>
+#include <monitor.h>
+#include <output_buffer.h>
 
 __BEGIN_SYS
 
 void System::init()
 {
+    if(Traits<System>::colorful && (CPU::id() == CPU::BSP)) {
+        // Colored heaps live in colored Segments attached to the system's address space
+        Address_Space as(MMU::current());
+        for(unsigned int c = WHITE + 1; c < COLORS; c++) {
+            Segment * seg = new (SYSTEM) Segment(COLOR_HEAP_SIZE, Segment::Flags(Segment::Flags::SYSD), static_cast<Color>(c));
+            _color_heap[c] = new (SYSTEM) Heap(as.attach(seg), seg->size());
+        }
+    }
+
     if(CPU::id() == CPU::BSP && Traits<Alarm>::enabled)
         Alarm::init();
 
     if(Traits<Thread>::enabled)
         Thread::init();
+
+    if(Traits<Monitor>::enabled)
+        Monitor::init();
+
+    if(Output_Buffer::buffered)
+        Output_Buffer::init();
 }
 
 __END_SYS
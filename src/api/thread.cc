@@ -3,6 +3,8 @@
 #include <machine.h>
 #include <system.h>
 #include <process.h>
+#include <monitor.h>
+#include <output_buffer.h>
 
 extern "C" { volatile unsigned long _running() __attribute__ ((alias ("_ZN4EPOS1S6Thread4selfEv"))); }
 
@@ -11,12 +13,16 @@ OStream cout;
 
 bool Thread::_not_booting;
 volatile unsigned int Thread::_thread_count;
-Scheduler_Timer * Thread::_timer;
-Scheduler<Thread> Thread::_scheduler;
-Spin Thread::_spin;
+volatile unsigned int Thread::_daemon_count;
+Scheduler_Timer * Thread::_timer __SCRATCHPAD_DATA;
+Scheduler<Thread> Thread::_scheduler __SCRATCHPAD_DATA;
+Spin Thread::_spin __SCRATCHPAD_DATA;
 volatile unsigned int Thread::_next_cpu = 0;
+Thread::Stack_Record Thread::_stack_records[STACK_RECORDS];
+unsigned int Thread::_stack_recorded;
+unsigned int Thread::_stack_max;
 
-void Thread::constructor_prologue(unsigned int stack_size)
+void Thread::constructor_prologue(unsigned int stack_size, Color color, bool scratchpad)
 {
     lock();
 
@@ -24,7 +30,21 @@ void Thread::constructor_prologue(unsigned int stack_size)
     db<Thread>(TRC) << "Thread::constructor_prologue( "  << "Thread queue() = " << this->criterion().queue() << " )"<< endl;
     _scheduler.insert(this);
 
-    _stack = new (SYSTEM) char[stack_size];
+    // With page coloring, threads of partitioned schedulers get stacks in their partition's colors unless told otherwise
+    if(Traits<System>::colorful && partitioned && (color == WHITE))
+        color = Segment::color(criterion().queue());
+    if(scratchpad)
+        _stack = new (SCRATCHPAD) char[stack_size];
+    else
+        _stack = (color == WHITE) ? new (SYSTEM) char[stack_size] : new (color) char[stack_size];
+    _stack_size = stack_size;
+
+    if(painted_stacks) {
+        unsigned long * s = reinterpret_cast<unsigned long *>(_stack);
+        for(unsigned int i = 0; i < stack_size / sizeof(long); i++)
+            s[i] = STACK_PAINT;
+        s[1] = STACK_CANARY;
+    }
 }
 
 
@@ -99,6 +119,79 @@ Thread::~Thread()
     unlock();
 
     delete _stack;
+    delete _pmu;
+}
+
+
+unsigned int Thread::stack_high_water() const
+{
+    if(!painted_stacks)
+        return _stack_size;
+
+    const unsigned long * s = reinterpret_cast<const unsigned long *>(_stack);
+    if(stack_overflown())
+        return _stack_size;
+
+    unsigned int i = 2; // past the exit status and the canary
+    while((i < _stack_size / sizeof(long)) && (s[i] == STACK_PAINT))
+        i++;
+
+    return _stack_size - i * sizeof(long);
+}
+
+
+void Thread::stack_report(OStream & os)
+{
+    if(!painted_stacks) {
+        os << "stack report requires Traits<Thread>::painted_stacks" << endl;
+        return;
+    }
+
+    // Records are only ever appended, so they can be read without locking
+    unsigned int n = (_stack_recorded < STACK_RECORDS) ? _stack_recorded : STACK_RECORDS;
+    for(unsigned int i = 0; i < n; i++)
+        os << "stack thread=" << _stack_records[i].thread << " size=" << _stack_records[i].size << " used=" << _stack_records[i].used
+           << " recommended=" << stack_recommended(_stack_records[i].used) << endl;
+    if(_stack_recorded > n)
+        os << "stack " << _stack_recorded - n << " more threads not listed" << endl;
+    os << "stack threads=" << _stack_recorded << " max_used=" << _stack_max << " STACK_SIZE=" << STACK_SIZE
+       << " recommended_STACK_SIZE=" << stack_recommended(_stack_max) << endl;
+}
+
+
+void Thread::stack_record()
+{
+    unsigned int used = stack_high_water();
+
+    if(_stack_recorded < STACK_RECORDS) {
+        _stack_records[_stack_recorded].thread = this;
+        _stack_records[_stack_recorded].size = _stack_size;
+        _stack_records[_stack_recorded].used = used;
+    }
+    _stack_recorded++;
+
+    if(used > _stack_max)
+        _stack_max = used;
+}
+
+
+unsigned int Thread::stack_recommended(unsigned int used)
+{
+    // A quarter more than the deepest use seen, rounded up to 256 bytes, since paths not exercised may go deeper
+    return (used + used / 4 + 255) / 256 * 256;
+}
+
+
+Thread::Criterion::Statistics Thread::statistics()
+{
+    lock();
+
+    // Take a consistent snapshot, since LEAVE/JOB_* events may be collected on other CPUs meanwhile
+    Criterion::Statistics s = const_cast<const Criterion::Statistics &>(criterion().statistics());
+
+    unlock();
+
+    return s;
 }
 
 
@@ -126,6 +219,72 @@ void Thread::priority(const Criterion & c)
 }
 
 
+void Thread::pmu_enable()
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::pmu_enable(this=" << this << ")" << endl;
+
+    if(!_pmu) {
+        _pmu = new (SYSTEM) PMU_Context();
+        if(this == running())
+            _pmu->enter();
+    }
+
+    unlock();
+}
+
+
+void Thread::pmu_disable()
+{
+    lock();
+
+    db<Thread>(TRC) << "Thread::pmu_disable(this=" << this << ")" << endl;
+
+    PMU_Context * pmu = _pmu;
+    _pmu = 0;
+
+    unlock();
+
+    delete pmu;
+}
+
+
+void Thread::pmu_reset()
+{
+    lock();
+
+    if(_pmu) {
+        for(unsigned int i = 0; i < PMU_CHANNELS; i++)
+            _pmu->count[i] = 0;
+        if(this == running())
+            _pmu->enter();
+    }
+
+    unlock();
+}
+
+
+PMU::Count Thread::pmu_read(PMU::Channel channel)
+{
+    assert(channel < PMU_CHANNELS);
+
+    lock();
+
+    PMU::Count count = 0;
+    if(_pmu) {
+        count = _pmu->count[channel];
+        // Counters are per-CPU, so the share of the ongoing activation is only visible to the thread itself
+        if(this == running())
+            count += PMU::read(channel) - _pmu->last[channel];
+    }
+
+    unlock();
+
+    return count;
+}
+
+
 int Thread::join()
 {
     lock();
@@ -238,6 +397,8 @@ void Thread::exit(int status)
     Thread * prev = running();
     _scheduler.remove(prev);
     prev->_state = FINISHING;
+    if(painted_stacks)
+        prev->stack_record();
     *reinterpret_cast<int *>(prev->_stack) = status;
     prev->criterion().collect(Criterion::FINISH);
 
@@ -427,15 +588,33 @@ void Thread::dispatch(Thread * prev, Thread * next, bool charge)
     }
 
     if(prev != next) {
-        if(Criterion::dynamic) {
+        // Not left to db<Thread>(ERR), which is compiled out unless Thread is debugged: the canary is only checked here
+        if(painted_stacks && prev->stack_overflown()) {
+            kerr << begl << "Thread::dispatch: stack overflow in thread " << prev << " (size=" << prev->_stack_size << ")!" << endl;
+            Output_Buffer::synchronize(true);
+            Machine::panic();
+        }
+
+        if(Criterion::dynamic || Criterion::collecting) {
             prev->criterion().collect(Criterion::CHARGE | Criterion::LEAVE);
-            update_all_priorities();
+            if(Criterion::dynamic)
+                update_all_priorities();
             next->criterion().collect(Criterion::AWARD  | Criterion::ENTER);
         }
         if(prev->_state == RUNNING)
             prev->_state = READY;
         next->_state = RUNNING;
 
+        if(Traits<PMU>::enabled) {
+            if(prev->_pmu)
+                prev->_pmu->leave();
+            if(next->_pmu)
+                next->_pmu->enter();
+        }
+
+        if(Monitor::enabled)
+            Monitor::dispatched(prev, next);
+
         db<Thread>(TRC) << "Thread::dispatch(prev=" << prev << ",next=" << next << ")" << endl;
         if(Traits<Thread>::debugged && Traits<Debug>::info) {
             CPU::Context tmp;
@@ -478,7 +657,10 @@ int Thread::idle()
 
     CPU::int_disable();
     if(CPU::id() == CPU::BSP) {
+        if(painted_stacks)
+            stack_report(cout);
         db<Thread>(WRN) << "The last thread has exited!" << endl;
+        Output_Buffer::synchronize();
         if(reboot) {
             db<Thread>(WRN) << "Rebooting the machine ..." << endl;
             Machine::reboot();
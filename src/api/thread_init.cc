@@ -25,7 +25,8 @@ void Thread::init()
     }
    
     // Idle thread creation does not cause rescheduling (see Thread::constructor_epilogue)
-    new (SYSTEM) Thread(Thread::Configuration(Thread::READY, Thread::IDLE), &Thread::idle);
+    // Idle threads take most interrupts of idle CPUs on their stacks, so these go to scratchpad memory if there is any
+    new (SYSTEM) Thread(Thread::Configuration(Thread::READY, Thread::IDLE, STACK_SIZE, WHITE, true), &Thread::idle);
 
     CPU::smp_barrier();
 
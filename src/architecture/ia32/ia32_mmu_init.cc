@@ -24,6 +24,21 @@ void MMU::init()
     // storage after the following is executed, but it will remain alive
     // This only works because the _free.insert_merging() only
     // touches the first page of each chunk and INIT is not there
+    // The buddy system, on the other hand, writes to the head of every
+    // aligned block it forms, and colored frames are freed one by one, so
+    // in these cases the pages INIT runs from (at most 64 KB, as checked by
+    // SETUP) are never handed to the allocator
+    static const unsigned int ini_base = Memory_Map::INIT;
+    static const unsigned int ini_top = Memory_Map::INIT + 64 * 1024;
+    auto white = [](unsigned int base, unsigned int top) {
+        if(buddy && (base < ini_top) && (top > ini_base)) {
+            if(base < ini_base)
+                white_free(base, pages(ini_base - base));
+            if(top > ini_top)
+                white_free(ini_top, pages(top - ini_top));
+        } else if(top > base)
+            white_free(base, pages(top - base));
+    };
 
     if(colorful) {
         int f1b = si->pmm.free1_base;
@@ -36,64 +51,71 @@ void MMU::init()
         // Insert a bulk of memory large enough to contain the System's heap into _free[WHITE] lists
         int size = Traits<System>::HEAP_SIZE;
         if((f1t - f1b) > size) {
-            white_free(f1b, pages(f1b + size));
+            white(f1b, f1b + size);
             f1b += size;
             size = 0;
         } else {
-            white_free(f1b, pages(f1t - f1b));
+            white(f1b, f1t);
             size -= (f1t - f1b);
             f1b = f1t = 0;
         }
         if(size > 0) {
             if((f2t - f2b) > size) {
-                white_free(f2b, pages(f2b + size));
+                white(f2b, f2b + size);
                 f2b += size;
                 size = 0;
             } else {
-                white_free(f2b, pages(f2t - f2b));
+                white(f2b, f2t);
                 size -= (f2t - f2b);
                 f2b = f2t = 0;
             }
         }
         if(size > 0) {
             if((f3t - f3b) > size) {
-                white_free(f3b, pages(f3b + size));
+                white(f3b, f3b + size);
                 f3b += size;
                 size = 0;
             } else {
-                white_free(f3b, pages(f3t - f3b));
+                white(f3b, f3t);
                 size -= (f3t - f3b);
                 f3b = f3t = 0;
             }
         }
-        if((size > 0) || (_free[WHITE].grouped_size() * sizeof(Page) < Traits<System>::HEAP_SIZE))
+        if((size > 0) || ((buddy ? _buddy.size() : _free[WHITE].grouped_size()) * sizeof(Page) < Traits<System>::HEAP_SIZE))
             db<Init, MMU>(ERR) << "MMU::int: System's heap size (Traits<System>::HEAP_SIZE=" << Traits<System>::HEAP_SIZE << ") is larger than memory!" << endl;
 
         // Insert the remaining free memory into the _free[color] lists
         int frame = f1b;
         while(frame < f1t) {
-            free(frame);
+            if((static_cast<unsigned int>(frame) < ini_base) || (static_cast<unsigned int>(frame) >= ini_top))
+                free(frame);
             frame += sizeof(Page);
         }
 
         frame = f2b;
         while(frame < f2t) {
-            free(frame);
+            if((static_cast<unsigned int>(frame) < ini_base) || (static_cast<unsigned int>(frame) >= ini_top))
+                free(frame);
             frame += sizeof(Page);
         }
 
         frame = f3b;
         while(frame < f3t) {
-            free(frame);
+            if((static_cast<unsigned int>(frame) < ini_base) || (static_cast<unsigned int>(frame) >= ini_top))
+                free(frame);
             frame += sizeof(Page);
         }
     } else {
         // Insert all free memory into the _free[WHITE] list
-        free(si->pmm.free1_base, pages(si->pmm.free1_top - si->pmm.free1_base));
-        free(si->pmm.free2_base, pages(si->pmm.free2_top - si->pmm.free2_base));
-        free(si->pmm.free3_base, pages(si->pmm.free3_top - si->pmm.free3_base));
+        white(si->pmm.free1_base, si->pmm.free1_top);
+        white(si->pmm.free2_base, si->pmm.free2_top);
+        white(si->pmm.free3_base, si->pmm.free3_top);
     }
 
+    // Keep the system mappings (GSYS) in the TLB across address space switches
+    // IA-32 only has PCIDs in IA-32e mode, so user mappings are still flushed by every CR3 reload
+    CPU::cr4(CPU::cr4() | CPU::CR4_PGE);
+
     // Remember the master page directory (created during SETUP)
     _master = current();
     db<Init, MMU>(INF) << "MMU::master page directory=" << _master << endl;
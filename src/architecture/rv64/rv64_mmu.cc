@@ -0,0 +1,22 @@
+// EPOS RISC-V 64 MMU Mediator Implementation
+
+#include <architecture/rv64/rv64_mmu.h>
+
+__BEGIN_SYS
+
+#ifdef __sv39__
+
+// Class attributes (only with SV39 as the system's MMU, since No_MMU needs none of them)
+SV39_MMU::List SV39_MMU::_free[colorful * COLORS + 1];
+SV39_MMU::Buddy SV39_MMU::_buddy;
+SV39_MMU::Page_Directory * SV39_MMU::_master;
+unsigned int SV39_MMU::_shares[FRAMES];
+volatile bool SV39_MMU::_lock;
+unsigned long SV39_MMU::_asids;
+unsigned long SV39_MMU::_asid_generation = SV39_MMU::ASID_MASK + 1;
+unsigned long SV39_MMU::_next_asid = 1;
+volatile bool SV39_MMU::_asid_flush[CPUS];
+
+#endif
+
+__END_SYS
@@ -5,8 +5,6 @@
 #include <machine.h>
 #include <system.h>
 
-extern "C" char _end; // defined by GCC
-
 __BEGIN_SYS
 
 class Init_Application
@@ -27,10 +25,13 @@ public:
 
         // Initialize Application's heap
         db<Init>(INF) << "Initializing application's heap: ";
-        if(Traits<System>::multiheap) { // heap in data segment arranged by SETUP
-            db<Init>(INF) << endl;
-            char * heap = (MMU::align_page(&_end) >= CPU::Log_Addr(Memory_Map::APP_DATA)) ? MMU::align_page(&_end) : CPU::Log_Addr(Memory_Map::APP_DATA); // ld is eliminating the data segment in some compilations, particularly for RISC-V, and placing _end in the code segment
-            Application::_heap = new (&Application::_preheap[0]) Heap(heap, HEAP_SIZE);
+        if(Traits<System>::multiheap) { // heaps in Segments attached to the application's address space, which grow on demand
+            db<Init>(INF) << Application::HEAPS << " heap(s)" << endl;
+            Address_Space as(MMU::current());
+            for(unsigned int i = 0; i < Application::HEAPS; i++) {
+                Segment * seg = new (SYSTEM) Segment(HEAP_SIZE / Application::HEAPS, Segment::Flags(Segment::Flags::APPD));
+                Application::_heap[i] = new (&Application::_preheap[i * sizeof(Segment_Heap)]) Segment_Heap(&as, seg, Segment::Flags::APPD);
+            }
         } else {
             db<Init>(INF) << "adding all free memory to the unified system's heap!" << endl;
             for(unsigned int frames = MMU::allocable(); frames; frames = MMU::allocable())
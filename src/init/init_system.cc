@@ -28,8 +28,11 @@ public:
             CPU::init();
 
             db<Init>(INF) << "Initializing system's heap: " << endl;
-            if(Traits<System>::multiheap) {
-                // Dont need to keep multiheap implementation here
+            if(Traits<System>::multiheap) { // in a Segment of its own, which grows on demand
+                System::_heap_segment = new (&System::_preheap[0]) Segment(HEAP_SIZE, Segment::Flags(Segment::Flags::SYSD));
+                Address_Space as(MMU::current());
+                CPU::Log_Addr addr = (Memory_Map::SYS_HEAP == Memory_Map::NOT_USED) ? CPU::Log_Addr(0) : CPU::Log_Addr(Memory_Map::SYS_HEAP);
+                System::_heap = new (&System::_preheap[sizeof(Segment)]) Segment_Heap(&as, System::_heap_segment, Segment::Flags::SYSD, addr);
             } else
                 System::_heap = new (&System::_preheap[0]) Heap(MMU::alloc(MMU::pages(HEAP_SIZE)), HEAP_SIZE);
             
@@ -148,6 +148,15 @@ void IC::exception(Interrupt_Id id)
     CPU::fr(4); // since exceptions do not increment PC, tell CPU::Context::pop(true) to perform PC = PC + 4 on return
 }
 
+void IC::page_fault(Interrupt_Id id)
+{
+    if(MMU::fault(CPU::tval(), id == CPU::EXC_DWPF)) {
+        db<IC>(TRC) << "IC::page_fault(i=" << id << ",tval=" << hex << CPU::tval() << dec << ") => mapped" << endl;
+        CPU::fr(0); // the faulting instruction must be executed again
+    } else
+        exception(id);
+}
+
 __END_SYS
 
 static void print_context(bool push) {
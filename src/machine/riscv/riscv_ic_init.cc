@@ -17,6 +17,11 @@ void IC::init()
     for(Interrupt_Id i = 0; i < EXCS; i++)
         _int_vector[i] = &exception;
 
+    // Page faults go through the MMU first, which maps lazy and copy-on-write pages
+    _int_vector[CPU::EXC_IPF] = &page_fault;
+    _int_vector[CPU::EXC_DRPF] = &page_fault;
+    _int_vector[CPU::EXC_DWPF] = &page_fault;
+
     // Set all interrupt handlers to int_not()
     for(Interrupt_Id i = EXCS; i < INTS; i++)
         _int_vector[i] = &int_not;
@@ -23,6 +23,11 @@ void Machine::init()
 
     if(Traits<Timer>::enabled)
         Timer::init();
+
+#ifdef __SCRATCHPAD_H
+    if(Traits<Scratchpad>::enabled)
+        Scratchpad::init();
+#endif
 }
 
 __END_SYS
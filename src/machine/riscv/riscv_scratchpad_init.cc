@@ -0,0 +1,28 @@
+// EPOS RISC-V Scratchpad Memory Initialization
+
+#include <machine/scratchpad.h>
+#include <system/memory_map.h>
+#include <system.h>
+#include <memory.h>
+
+// End of the __SCRATCHPAD_DATA objects (defined by the linker)
+extern "C" { extern char __stop_scratchpad[] __attribute__((weak)); }
+
+__BEGIN_SYS
+
+void Scratchpad::init()
+{
+    db<Init, Scratchpad>(TRC) << "Scratchpad::init(a=" << CPU::Phy_Addr(ADDRESS) << ",s=" << SIZE << ")" << endl;
+
+    // When eposcc links __SCRATCHPAD_DATA at the scratchpad's base, the heap only gets the pages after it
+    unsigned long used = 0;
+    if((Memory_Map::SCRATCHPAD != Memory_Map::NOT_USED) && __stop_scratchpad)
+        used = MMU::align_page(reinterpret_cast<unsigned long>(__stop_scratchpad) - ADDRESS);
+
+    db<Init, Scratchpad>(INF) << "Scratchpad::init: " << used << " bytes taken by __SCRATCHPAD_DATA" << endl;
+
+    _segment = new (SYSTEM) Segment(CPU::Phy_Addr(ADDRESS + used), SIZE - used, MMU::Flags::SYSD);
+    _heap = new (SYSTEM) Heap(Address_Space(MMU::current()).attach(_segment), _segment->size());
+}
+
+__END_SYS
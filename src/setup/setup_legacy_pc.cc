@@ -245,12 +245,10 @@ void Setup::build_lm()
             db<Setup>(WRN) << "APP ELF image has no data segment!" << endl;
             si->lm.app_data = MMU::align_page(APP_DATA);
         }
-        if(Traits<System>::multiheap) { // Application heap in data segment
+        if(Traits<System>::multiheap) { // Application stack in data segment (heaps are Segments created by INIT)
             si->lm.app_data_size = MMU::align_page(si->lm.app_data_size);
             si->lm.app_stack = si->lm.app_data + si->lm.app_data_size;
             si->lm.app_data_size += MMU::align_page(Traits<Application>::STACK_SIZE);
-            si->lm.app_heap = si->lm.app_data + si->lm.app_data_size;
-            si->lm.app_data_size += MMU::align_page(Traits<Application>::HEAP_SIZE);
         }
         if(si->lm.has_ext) { // Check for EXTRA data in the boot image
             si->lm.app_extra = si->lm.app_data + si->lm.app_data_size;
@@ -480,38 +478,38 @@ void Setup::setup_sys_pt()
     memset(sys_pt, 0, pts * sizeof(Page_Table));
 
     // IDT
-    sys_pt[MMU::pti(SYS, IDT)] = si->pmm.idt | Flags::SYS;
+    sys_pt[MMU::pti(SYS, IDT)] = si->pmm.idt | Flags::GSYS;
 
     // GDT
-    sys_pt[MMU::pti(SYS, GDT)] = si->pmm.gdt | Flags::SYS;
+    sys_pt[MMU::pti(SYS, GDT)] = si->pmm.gdt | Flags::GSYS;
 
     // TSSs
     for(unsigned int i = 0; i < Traits<Machine>::CPUS; i++)
-        sys_pt[MMU::pti(SYS, TSS0) + i] = (si->pmm.tss + i * sizeof(Page)) | Flags::SYS;
+        sys_pt[MMU::pti(SYS, TSS0) + i] = (si->pmm.tss + i * sizeof(Page)) | Flags::GSYS;
 
     // System Info
-    sys_pt[MMU::pti(SYS, SYS_INFO)] = MMU::phy2pte(si->pmm.sys_info, Flags::SYS);
+    sys_pt[MMU::pti(SYS, SYS_INFO)] = MMU::phy2pte(si->pmm.sys_info, Flags::GSYS);
 
     // Set an entry to this page table, so the system can access it later
-    sys_pt[MMU::pti(SYS, SYS_PT)] = MMU::phy2pte(si->pmm.sys_pt, Flags::SYS);
+    sys_pt[MMU::pti(SYS, SYS_PT)] = MMU::phy2pte(si->pmm.sys_pt, Flags::GSYS);
 
     // System Page Directory
-    sys_pt[MMU::pti(SYS, SYS_PD)] = MMU::phy2pte(si->pmm.sys_pd, Flags::SYS);
+    sys_pt[MMU::pti(SYS, SYS_PD)] = MMU::phy2pte(si->pmm.sys_pd, Flags::GSYS);
 
     unsigned int i;
     PT_Entry aux;
 
     // SYSTEM code
     for(i = 0, aux = si->pmm.sys_code; i < MMU::pages(si->lm.sys_code_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::pti(SYS, SYS_CODE) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[MMU::pti(SYS, SYS_CODE) + i] = MMU::phy2pte(aux, Flags::GSYS);
 
     // SYSTEM data
     for(i = 0, aux = si->pmm.sys_data; i < MMU::pages(si->lm.sys_data_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::pti(SYS, SYS_DATA) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[MMU::pti(SYS, SYS_DATA) + i] = MMU::phy2pte(aux, Flags::GSYS);
 
     // SYSTEM stack (used only during init and for the ukernel model)
     for(i = 0, aux = si->pmm.sys_stack; i < MMU::pages(si->lm.sys_stack_size); i++, aux = aux + sizeof(Page))
-        sys_pt[MMU::pti(SYS, SYS_STACK) + i] = MMU::phy2pte(aux, Flags::SYS);
+        sys_pt[MMU::pti(SYS, SYS_STACK) + i] = MMU::phy2pte(aux, Flags::GSYS);
 
     // SYSTEM heap is handled by Init_System, so we don't map it here!
 
@@ -260,12 +260,10 @@ void Setup::build_lm()
             db<Setup>(WRN) << "APP ELF image has no data segment!" << endl;
             si->lm.app_data = MMU::align_page(APP_DATA);
         }
-        if(Traits<System>::multiheap) { // Application heap in data segment
+        if(Traits<System>::multiheap) { // Application stack in data segment (heaps are Segments created by INIT)
             si->lm.app_data_size = MMU::align_page(si->lm.app_data_size);
             si->lm.app_stack = si->lm.app_data + si->lm.app_data_size;
             si->lm.app_data_size += MMU::align_page(Traits<Application>::STACK_SIZE);
-            si->lm.app_heap = si->lm.app_data + si->lm.app_data_size;
-            si->lm.app_data_size += MMU::align_page(Traits<Application>::HEAP_SIZE);
         }
         if(si->lm.has_ext) { // Check for EXTRA data in the boot image
             si->lm.app_extra = si->lm.app_data + si->lm.app_data_size;
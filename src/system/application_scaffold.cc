@@ -6,7 +6,7 @@ __BEGIN_SYS
 
 // Application class attributes
 char Application::_preheap[];
-Heap * Application::_heap;
+Heap * Application::_heap[HEAPS];
 
 __END_SYS
 
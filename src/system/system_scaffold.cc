@@ -6,6 +6,7 @@
 #include <memory.h>
 #include <process.h>
 #include <system.h>
+#include <output_buffer.h>
 
 extern char __boot_time_system_info[];
 
@@ -21,6 +22,7 @@ System_Info * System::_si = (Memory_Map::SYS_INFO != Memory_Map::NOT_USED) ? rei
 char System::_preheap[];
 Segment * System::_heap_segment;
 Heap * System::_heap;
+Heap * System::_color_heap[COLORS];
 
 __END_SYS
 
@@ -38,9 +40,19 @@ extern "C" {
     // OStream
     static volatile int _setup_print_lock = -1;
     static volatile int _lock = 0;
-    void _print(const char * s) { Display::puts(s); }
+    void _print(const char * s) {
+        if(Output_Buffer::enabled())
+            Output_Buffer::put(s);
+        else
+            Display::puts(s);
+    }
     void _print_preamble() {
-        if(Traits<System>::multicore) {
+        if(Traits<System>::multicore && Output_Buffer::enabled()) {
+            // Lines are assembled per-core, so they cannot interleave and there is no need to hold the Display
+            char tag[] = "<0>: ";
+            tag[1] = '0' + CPU::id();
+            _print(tag);
+        } else if(Traits<System>::multicore) {
             static char tag[] = "<0>: ";
 
             int me = CPU::id();
@@ -53,7 +65,11 @@ extern "C" {
         }
     }
     void _print_trailler(bool error) {
-        if(Traits<System>::multicore) {
+        if(Traits<System>::multicore && Output_Buffer::enabled()) {
+            char tag[] = " :<0>";
+            tag[3] = '0' + CPU::id();
+            _print(tag);
+        } else if(Traits<System>::multicore) {
             static char tag[] = " :<0>";
 
             if(_setup_print_lock != -1) {
@@ -63,7 +79,10 @@ extern "C" {
                 _setup_print_lock = -1;
             }
         }
-        if(error)
+        if(error) {
+            // Whatever is still buffered (including this line) must make it out before the machine stops
+            Output_Buffer::synchronize(true);
             Machine::panic();
+        }
     }
 }
@@ -68,107 +68,184 @@ const unsigned char SWAES<16>::rcon[255] = {
 	   0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd,
 	   0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb  };
 
-void SWAES<16>::ebc_encrypt(const unsigned char * input, const unsigned char * key, unsigned char * output)
+// T-tables: te[x] is column x of MixColumns applied to S[x] (big-endian), td[x] that of InvMixColumns to S^-1[x]
+// Rotating them right by 8, 16 and 24 bits gives the tables of the other rows
+const unsigned int SWAES<16>::te[256] = {
+    0xc66363a5, 0xf87c7c84, 0xee777799, 0xf67b7b8d, 0xfff2f20d, 0xd66b6bbd, 0xde6f6fb1, 0x91c5c554,
+    0x60303050, 0x02010103, 0xce6767a9, 0x562b2b7d, 0xe7fefe19, 0xb5d7d762, 0x4dababe6, 0xec76769a,
+    0x8fcaca45, 0x1f82829d, 0x89c9c940, 0xfa7d7d87, 0xeffafa15, 0xb25959eb, 0x8e4747c9, 0xfbf0f00b,
+    0x41adadec, 0xb3d4d467, 0x5fa2a2fd, 0x45afafea, 0x239c9cbf, 0x53a4a4f7, 0xe4727296, 0x9bc0c05b,
+    0x75b7b7c2, 0xe1fdfd1c, 0x3d9393ae, 0x4c26266a, 0x6c36365a, 0x7e3f3f41, 0xf5f7f702, 0x83cccc4f,
+    0x6834345c, 0x51a5a5f4, 0xd1e5e534, 0xf9f1f108, 0xe2717193, 0xabd8d873, 0x62313153, 0x2a15153f,
+    0x0804040c, 0x95c7c752, 0x46232365, 0x9dc3c35e, 0x30181828, 0x379696a1, 0x0a05050f, 0x2f9a9ab5,
+    0x0e070709, 0x24121236, 0x1b80809b, 0xdfe2e23d, 0xcdebeb26, 0x4e272769, 0x7fb2b2cd, 0xea75759f,
+    0x1209091b, 0x1d83839e, 0x582c2c74, 0x341a1a2e, 0x361b1b2d, 0xdc6e6eb2, 0xb45a5aee, 0x5ba0a0fb,
+    0xa45252f6, 0x763b3b4d, 0xb7d6d661, 0x7db3b3ce, 0x5229297b, 0xdde3e33e, 0x5e2f2f71, 0x13848497,
+    0xa65353f5, 0xb9d1d168, 0x00000000, 0xc1eded2c, 0x40202060, 0xe3fcfc1f, 0x79b1b1c8, 0xb65b5bed,
+    0xd46a6abe, 0x8dcbcb46, 0x67bebed9, 0x7239394b, 0x944a4ade, 0x984c4cd4, 0xb05858e8, 0x85cfcf4a,
+    0xbbd0d06b, 0xc5efef2a, 0x4faaaae5, 0xedfbfb16, 0x864343c5, 0x9a4d4dd7, 0x66333355, 0x11858594,
+    0x8a4545cf, 0xe9f9f910, 0x04020206, 0xfe7f7f81, 0xa05050f0, 0x783c3c44, 0x259f9fba, 0x4ba8a8e3,
+    0xa25151f3, 0x5da3a3fe, 0x804040c0, 0x058f8f8a, 0x3f9292ad, 0x219d9dbc, 0x70383848, 0xf1f5f504,
+    0x63bcbcdf, 0x77b6b6c1, 0xafdada75, 0x42212163, 0x20101030, 0xe5ffff1a, 0xfdf3f30e, 0xbfd2d26d,
+    0x81cdcd4c, 0x180c0c14, 0x26131335, 0xc3ecec2f, 0xbe5f5fe1, 0x359797a2, 0x884444cc, 0x2e171739,
+    0x93c4c457, 0x55a7a7f2, 0xfc7e7e82, 0x7a3d3d47, 0xc86464ac, 0xba5d5de7, 0x3219192b, 0xe6737395,
+    0xc06060a0, 0x19818198, 0x9e4f4fd1, 0xa3dcdc7f, 0x44222266, 0x542a2a7e, 0x3b9090ab, 0x0b888883,
+    0x8c4646ca, 0xc7eeee29, 0x6bb8b8d3, 0x2814143c, 0xa7dede79, 0xbc5e5ee2, 0x160b0b1d, 0xaddbdb76,
+    0xdbe0e03b, 0x64323256, 0x743a3a4e, 0x140a0a1e, 0x924949db, 0x0c06060a, 0x4824246c, 0xb85c5ce4,
+    0x9fc2c25d, 0xbdd3d36e, 0x43acacef, 0xc46262a6, 0x399191a8, 0x319595a4, 0xd3e4e437, 0xf279798b,
+    0xd5e7e732, 0x8bc8c843, 0x6e373759, 0xda6d6db7, 0x018d8d8c, 0xb1d5d564, 0x9c4e4ed2, 0x49a9a9e0,
+    0xd86c6cb4, 0xac5656fa, 0xf3f4f407, 0xcfeaea25, 0xca6565af, 0xf47a7a8e, 0x47aeaee9, 0x10080818,
+    0x6fbabad5, 0xf0787888, 0x4a25256f, 0x5c2e2e72, 0x381c1c24, 0x57a6a6f1, 0x73b4b4c7, 0x97c6c651,
+    0xcbe8e823, 0xa1dddd7c, 0xe874749c, 0x3e1f1f21, 0x964b4bdd, 0x61bdbddc, 0x0d8b8b86, 0x0f8a8a85,
+    0xe0707090, 0x7c3e3e42, 0x71b5b5c4, 0xcc6666aa, 0x904848d8, 0x06030305, 0xf7f6f601, 0x1c0e0e12,
+    0xc26161a3, 0x6a35355f, 0xae5757f9, 0x69b9b9d0, 0x17868691, 0x99c1c158, 0x3a1d1d27, 0x279e9eb9,
+    0xd9e1e138, 0xebf8f813, 0x2b9898b3, 0x22111133, 0xd26969bb, 0xa9d9d970, 0x078e8e89, 0x339494a7,
+    0x2d9b9bb6, 0x3c1e1e22, 0x15878792, 0xc9e9e920, 0x87cece49, 0xaa5555ff, 0x50282878, 0xa5dfdf7a,
+    0x038c8c8f, 0x59a1a1f8, 0x09898980, 0x1a0d0d17, 0x65bfbfda, 0xd7e6e631, 0x844242c6, 0xd06868b8,
+    0x824141c3, 0x299999b0, 0x5a2d2d77, 0x1e0f0f11, 0x7bb0b0cb, 0xa85454fc, 0x6dbbbbd6, 0x2c16163a };
+
+const unsigned int SWAES<16>::td[256] = {
+    0x51f4a750, 0x7e416553, 0x1a17a4c3, 0x3a275e96, 0x3bab6bcb, 0x1f9d45f1, 0xacfa58ab, 0x4be30393,
+    0x2030fa55, 0xad766df6, 0x88cc7691, 0xf5024c25, 0x4fe5d7fc, 0xc52acbd7, 0x26354480, 0xb562a38f,
+    0xdeb15a49, 0x25ba1b67, 0x45ea0e98, 0x5dfec0e1, 0xc32f7502, 0x814cf012, 0x8d4697a3, 0x6bd3f9c6,
+    0x038f5fe7, 0x15929c95, 0xbf6d7aeb, 0x955259da, 0xd4be832d, 0x587421d3, 0x49e06929, 0x8ec9c844,
+    0x75c2896a, 0xf48e7978, 0x99583e6b, 0x27b971dd, 0xbee14fb6, 0xf088ad17, 0xc920ac66, 0x7dce3ab4,
+    0x63df4a18, 0xe51a3182, 0x97513360, 0x62537f45, 0xb16477e0, 0xbb6bae84, 0xfe81a01c, 0xf9082b94,
+    0x70486858, 0x8f45fd19, 0x94de6c87, 0x527bf8b7, 0xab73d323, 0x724b02e2, 0xe31f8f57, 0x6655ab2a,
+    0xb2eb2807, 0x2fb5c203, 0x86c57b9a, 0xd33708a5, 0x302887f2, 0x23bfa5b2, 0x02036aba, 0xed16825c,
+    0x8acf1c2b, 0xa779b492, 0xf307f2f0, 0x4e69e2a1, 0x65daf4cd, 0x0605bed5, 0xd134621f, 0xc4a6fe8a,
+    0x342e539d, 0xa2f355a0, 0x058ae132, 0xa4f6eb75, 0x0b83ec39, 0x4060efaa, 0x5e719f06, 0xbd6e1051,
+    0x3e218af9, 0x96dd063d, 0xdd3e05ae, 0x4de6bd46, 0x91548db5, 0x71c45d05, 0x0406d46f, 0x605015ff,
+    0x1998fb24, 0xd6bde997, 0x894043cc, 0x67d99e77, 0xb0e842bd, 0x07898b88, 0xe7195b38, 0x79c8eedb,
+    0xa17c0a47, 0x7c420fe9, 0xf8841ec9, 0x00000000, 0x09808683, 0x322bed48, 0x1e1170ac, 0x6c5a724e,
+    0xfd0efffb, 0x0f853856, 0x3daed51e, 0x362d3927, 0x0a0fd964, 0x685ca621, 0x9b5b54d1, 0x24362e3a,
+    0x0c0a67b1, 0x9357e70f, 0xb4ee96d2, 0x1b9b919e, 0x80c0c54f, 0x61dc20a2, 0x5a774b69, 0x1c121a16,
+    0xe293ba0a, 0xc0a02ae5, 0x3c22e043, 0x121b171d, 0x0e090d0b, 0xf28bc7ad, 0x2db6a8b9, 0x141ea9c8,
+    0x57f11985, 0xaf75074c, 0xee99ddbb, 0xa37f60fd, 0xf701269f, 0x5c72f5bc, 0x44663bc5, 0x5bfb7e34,
+    0x8b432976, 0xcb23c6dc, 0xb6edfc68, 0xb8e4f163, 0xd731dcca, 0x42638510, 0x13972240, 0x84c61120,
+    0x854a247d, 0xd2bb3df8, 0xaef93211, 0xc729a16d, 0x1d9e2f4b, 0xdcb230f3, 0x0d8652ec, 0x77c1e3d0,
+    0x2bb3166c, 0xa970b999, 0x119448fa, 0x47e96422, 0xa8fc8cc4, 0xa0f03f1a, 0x567d2cd8, 0x223390ef,
+    0x87494ec7, 0xd938d1c1, 0x8ccaa2fe, 0x98d40b36, 0xa6f581cf, 0xa57ade28, 0xdab78e26, 0x3fadbfa4,
+    0x2c3a9de4, 0x5078920d, 0x6a5fcc9b, 0x547e4662, 0xf68d13c2, 0x90d8b8e8, 0x2e39f75e, 0x82c3aff5,
+    0x9f5d80be, 0x69d0937c, 0x6fd52da9, 0xcf2512b3, 0xc8ac993b, 0x10187da7, 0xe89c636e, 0xdb3bbb7b,
+    0xcd267809, 0x6e5918f4, 0xec9ab701, 0x834f9aa8, 0xe6956e65, 0xaaffe67e, 0x21bccf08, 0xef15e8e6,
+    0xbae79bd9, 0x4a6f36ce, 0xea9f09d4, 0x29b07cd6, 0x31a4b2af, 0x2a3f2331, 0xc6a59430, 0x35a266c0,
+    0x744ebc37, 0xfc82caa6, 0xe090d0b0, 0x33a7d815, 0xf104984a, 0x41ecdaf7, 0x7fcd500e, 0x1791f62f,
+    0x764dd68d, 0x43efb04d, 0xccaa4d54, 0xe49604df, 0x9ed1b5e3, 0x4c6a881b, 0xc12c1fb8, 0x4665517f,
+    0x9d5eea04, 0x018c355d, 0xfa877473, 0xfb0b412e, 0xb3671d5a, 0x92dbd252, 0xe9105633, 0x6dd64713,
+    0x9ad7618c, 0x37a10c7a, 0x59f8148e, 0xeb133c89, 0xcea927ee, 0xb761c935, 0xe11ce5ed, 0x7a47b13c,
+    0x9cd2df59, 0x55f2733f, 0x1814ce79, 0x73c737bf, 0x53f7cdea, 0x5ffdaa5b, 0xdf3d6f14, 0x7844db86,
+    0xcaaff381, 0xb968c43e, 0x3824342c, 0xc2a3405f, 0x161dc372, 0xbce2250c, 0x283c498b, 0xff0d9541,
+    0x39a80171, 0x080cb3de, 0xd8b4e49c, 0x6456c190, 0x7bcb8461, 0xd532b670, 0x486c5c74, 0xd0b85742 };
+
+void SWAES<16>::key(const unsigned char * k)
 {
-    // Copy input to output, and work in-memory on output
-    block_copy(output, input);
-    _state = reinterpret_cast<State *>(output);
-
-    _key = key;
+    memcpy(_key, k, KEY_SIZE);
     expand_key();
 
-    // The next function call encrypts the PlainText with the _key using AES algorithm.
-    cipher();
-}
-
-void SWAES<16>::ebc_decrypt(const unsigned char * input, const unsigned char * key, unsigned char *output)
-{
-    // Copy input to output, and work in-memory on output
-    block_copy(output, input);
-    _state = reinterpret_cast<State *>(output);
-
-    // The expand_key routine must be called before encryption.
-    _key = key;
-    expand_key();
+    for(unsigned int i = 0; i < Nb * (Nr + 1); i++)
+        _encryption_key[i] = load(&_round_key[i * 4]);
+
+    // The equivalent inverse cipher takes the round keys in reverse order, with InvMixColumns applied to the inner ones
+    // (td[S[x]] is InvMixColumns of x alone)
+    for(unsigned int r = 0; r <= Nr; r++)
+        for(unsigned int j = 0; j < Nb; j++) {
+            unsigned int w = _encryption_key[(Nr - r) * Nb + j];
+            if((r > 0) && (r < Nr))
+                w = td[sbox[w >> 24]] ^ ror(td[sbox[(w >> 16) & 0xff]], 8) ^ ror(td[sbox[(w >> 8) & 0xff]], 16) ^ ror(td[sbox[w & 0xff]], 24);
+            _decryption_key[r * Nb + j] = w;
+        }
 
-    inv_cipher();
+    _keyed = true;
 }
 
-void SWAES<16>::cbc_encrypt_buffer(unsigned char * output, const unsigned char * _input, int length, const unsigned char * key, unsigned char * iv)
+void SWAES<16>::encrypt(const unsigned char * data, unsigned char * result)
 {
-    unsigned char remainders = length % KEY_SIZE; /* Remaining bytes in the last non-full block */
-
-    block_copy(output, _input);
-    _state = reinterpret_cast<State *>(output);
-
-    // Skip the key expansion if key is passed as 0
-    if(0 != key) {
-        _key = key;
-        expand_key();
+    if(hardware) {
+        hardware_encrypt(data, result);
+        return;
     }
 
-    if(iv != 0)
-        _iv = iv;
-
-    int i;
-    for(i = 0; i < length; i += KEY_SIZE) {
-        unsigned char input[KEY_SIZE];
-        for(int j=0; (j<(int)KEY_SIZE) && (j+i < length); j++)
-            input[j] = _input[j+i];
-        xor_with_iv(input);
-        block_copy(output, input);
-        _state = reinterpret_cast<State *>(output);
-        cipher();
-        _iv = output;
-        output += KEY_SIZE;
+    const unsigned int * rk = _encryption_key;
+    unsigned int s0 = load(data) ^ rk[0];
+    unsigned int s1 = load(data + 4) ^ rk[1];
+    unsigned int s2 = load(data + 8) ^ rk[2];
+    unsigned int s3 = load(data + 12) ^ rk[3];
+
+    for(int round = 1; round < Nr; round++) {
+        rk += Nb;
+        unsigned int t0 = te[s0 >> 24] ^ ror(te[(s1 >> 16) & 0xff], 8) ^ ror(te[(s2 >> 8) & 0xff], 16) ^ ror(te[s3 & 0xff], 24) ^ rk[0];
+        unsigned int t1 = te[s1 >> 24] ^ ror(te[(s2 >> 16) & 0xff], 8) ^ ror(te[(s3 >> 8) & 0xff], 16) ^ ror(te[s0 & 0xff], 24) ^ rk[1];
+        unsigned int t2 = te[s2 >> 24] ^ ror(te[(s3 >> 16) & 0xff], 8) ^ ror(te[(s0 >> 8) & 0xff], 16) ^ ror(te[s1 & 0xff], 24) ^ rk[2];
+        unsigned int t3 = te[s3 >> 24] ^ ror(te[(s0 >> 16) & 0xff], 8) ^ ror(te[(s1 >> 8) & 0xff], 16) ^ ror(te[s2 & 0xff], 24) ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
     }
 
-    if(remainders) {
-        block_copy(output, _input+i);
-        memset(output + remainders, 0, KEY_SIZE - remainders); /* add 0-padding */
-        _state = reinterpret_cast<State *>(output);
-        cipher();
-    }
+    // The last round has no MixColumns
+    rk += Nb;
+    store(result, word(sbox[s0 >> 24], sbox[(s1 >> 16) & 0xff], sbox[(s2 >> 8) & 0xff], sbox[s3 & 0xff]) ^ rk[0]);
+    store(result + 4, word(sbox[s1 >> 24], sbox[(s2 >> 16) & 0xff], sbox[(s3 >> 8) & 0xff], sbox[s0 & 0xff]) ^ rk[1]);
+    store(result + 8, word(sbox[s2 >> 24], sbox[(s3 >> 16) & 0xff], sbox[(s0 >> 8) & 0xff], sbox[s1 & 0xff]) ^ rk[2]);
+    store(result + 12, word(sbox[s3 >> 24], sbox[(s0 >> 16) & 0xff], sbox[(s1 >> 8) & 0xff], sbox[s2 & 0xff]) ^ rk[3]);
 }
 
-void SWAES<16>::cbc_decrypt_buffer(unsigned char * output, const unsigned char * input, int length, const unsigned char * key, unsigned char * iv)
+void SWAES<16>::decrypt(const unsigned char * data, unsigned char * result)
 {
-    int i;
-    unsigned char remainders = length % KEY_SIZE; /* Remaining bytes in the last non-full block */
-
-    block_copy(output, input);
-    _state = reinterpret_cast<State *>(output);
-
-    // Skip the key expansion if key is passed as 0
-    if(0 != key) {
-        _key = key;
-        expand_key();
+    const unsigned int * rk = _decryption_key;
+    unsigned int s0 = load(data) ^ rk[0];
+    unsigned int s1 = load(data + 4) ^ rk[1];
+    unsigned int s2 = load(data + 8) ^ rk[2];
+    unsigned int s3 = load(data + 12) ^ rk[3];
+
+    for(int round = 1; round < Nr; round++) {
+        rk += Nb;
+        unsigned int t0 = td[s0 >> 24] ^ ror(td[(s3 >> 16) & 0xff], 8) ^ ror(td[(s2 >> 8) & 0xff], 16) ^ ror(td[s1 & 0xff], 24) ^ rk[0];
+        unsigned int t1 = td[s1 >> 24] ^ ror(td[(s0 >> 16) & 0xff], 8) ^ ror(td[(s3 >> 8) & 0xff], 16) ^ ror(td[s2 & 0xff], 24) ^ rk[1];
+        unsigned int t2 = td[s2 >> 24] ^ ror(td[(s1 >> 16) & 0xff], 8) ^ ror(td[(s0 >> 8) & 0xff], 16) ^ ror(td[s3 & 0xff], 24) ^ rk[2];
+        unsigned int t3 = td[s3 >> 24] ^ ror(td[(s2 >> 16) & 0xff], 8) ^ ror(td[(s1 >> 8) & 0xff], 16) ^ ror(td[s0 & 0xff], 24) ^ rk[3];
+        s0 = t0; s1 = t1; s2 = t2; s3 = t3;
     }
 
-    // If iv is passed as 0, we continue to encrypt without re-setting the _iv
-    if(iv != 0)
-        _iv = iv;
-
-    for(i = 0; i < length; i += KEY_SIZE) {
-        block_copy(output, input);
-        _state = reinterpret_cast<State *>(output);
-        inv_cipher();
-        xor_with_iv(output);
-        _iv = const_cast<unsigned char *>(input);
-        input += KEY_SIZE;
-        output += KEY_SIZE;
-    }
+    rk += Nb;
+    store(result, word(rsbox[s0 >> 24], rsbox[(s3 >> 16) & 0xff], rsbox[(s2 >> 8) & 0xff], rsbox[s1 & 0xff]) ^ rk[0]);
+    store(result + 4, word(rsbox[s1 >> 24], rsbox[(s0 >> 16) & 0xff], rsbox[(s3 >> 8) & 0xff], rsbox[s2 & 0xff]) ^ rk[1]);
+    store(result + 8, word(rsbox[s2 >> 24], rsbox[(s1 >> 16) & 0xff], rsbox[(s0 >> 8) & 0xff], rsbox[s3 & 0xff]) ^ rk[2]);
+    store(result + 12, word(rsbox[s3 >> 24], rsbox[(s2 >> 16) & 0xff], rsbox[(s1 >> 8) & 0xff], rsbox[s0 & 0xff]) ^ rk[3]);
+}
 
-    if(remainders) {
-        block_copy(output, input);
-        memset(output+remainders, 0, KEY_SIZE - remainders); /* add 0-padding */
-        _state = reinterpret_cast<State *>(output);
-        inv_cipher();
-    }
+void SWAES<16>::hardware_encrypt(const unsigned char * data, unsigned char * result)
+{
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || defined(__AES__)
+    typedef unsigned char Block __attribute__ ((vector_size(BLOCK_SIZE)));
+
+    Block s, rk[Nr + 1];
+    memcpy(&s, data, BLOCK_SIZE);
+    memcpy(rk, _round_key, sizeof(rk));
+
+#if defined(__AES__)
+    s ^= rk[0];
+    for(int round = 1; round < Nr; round++)
+        ASM("aesenc %1, %0" : "+x"(s) : "x"(rk[round]));
+    ASM("aesenclast %1, %0" : "+x"(s) : "x"(rk[Nr]));
+#elif defined(__aarch64__)
+    // AESE does AddRoundKey, SubBytes and ShiftRows; AESMC does MixColumns
+    for(int round = 0; round < Nr - 1; round++)
+        ASM("aese %0.16b, %1.16b \n aesmc %0.16b, %0.16b" : "+w"(s) : "w"(rk[round]));
+    ASM("aese %0.16b, %1.16b" : "+w"(s) : "w"(rk[Nr - 1]));
+    s ^= rk[Nr];
+#else
+    for(int round = 0; round < Nr - 1; round++)
+        ASM("aese.8 %q0, %q1 \n aesmc.8 %q0, %q0" : "+w"(s) : "w"(rk[round]));
+    ASM("aese.8 %q0, %q1" : "+w"(s) : "w"(rk[Nr - 1]));
+    s ^= rk[Nr];
+#endif
+
+    memcpy(result, &s, BLOCK_SIZE);
+#endif
 }
 
 // This function produces Nb(Nr+1) round keys. The round keys are used in each round to decrypt the states.
-void SWAES<16>::expand_key(void)
+void SWAES<16>::expand_key()
 {
     unsigned int i, j, k;
     unsigned char tempa[4]; // Used for the column/row operations
@@ -227,185 +304,4 @@ void SWAES<16>::expand_key(void)
     }
 }
 
-// This function adds the round key to _state.
-// The round key is added to the _state by an XOR function.
-void SWAES<16>::add_round_key(int round)
-{
-    int i,j;
-    for(i=0;i<4;++i) {
-        for(j = 0; j < 4; ++j) {
-            (*_state)[i][j] ^= _round_key[round * Nb * 4 + i * Nb + j];
-        }
-    }
-}
-
-// The sub_bytes Function Substitutes the values in the
-// _state matrix with values in an S-box.
-void SWAES<16>::sub_bytes(void)
-{
-    int i, j;
-    for(i = 0; i < 4; ++i) {
-        for(j = 0; j < 4; ++j) {
-            (*_state)[j][i] = sbox[static_cast<int>((*_state)[j][i])];
-        }
-    }
-}
-
-// The shift_rows() function shifts the rows in the _state to the left.
-// Each row is shifted with different offset.
-// Offset = Row number. So the first row is not shifted.
-void SWAES<16>::shift_rows(void)
-{
-    unsigned char temp;
-
-    // Rotate first row 1 columns to left
-    temp            = (*_state)[0][1];
-    (*_state)[0][1] = (*_state)[1][1];
-    (*_state)[1][1] = (*_state)[2][1];
-    (*_state)[2][1] = (*_state)[3][1];
-    (*_state)[3][1] = temp;
-
-    // Rotate second row 2 columns to left
-    temp            = (*_state)[0][2];
-    (*_state)[0][2] = (*_state)[2][2];
-    (*_state)[2][2] = temp;
-
-    temp            = (*_state)[1][2];
-    (*_state)[1][2] = (*_state)[3][2];
-    (*_state)[3][2] = temp;
-
-    // Rotate third row 3 columns to left
-    temp            = (*_state)[0][3];
-    (*_state)[0][3] = (*_state)[3][3];
-    (*_state)[3][3] = (*_state)[2][3];
-    (*_state)[2][3] = (*_state)[1][3];
-    (*_state)[1][3] = temp;
-}
-
-// mix_columns function mixes the columns of the _state matrix
-void SWAES<16>::mix_columns(void)
-{
-    int i;
-    unsigned char Tmp,Tm,t;
-    for(i = 0; i < 4; ++i) {
-        t   = (*_state)[i][0];
-        Tmp = (*_state)[i][0] ^ (*_state)[i][1] ^ (*_state)[i][2] ^ (*_state)[i][3] ;
-        Tm  = (*_state)[i][0] ^ (*_state)[i][1] ; Tm = xtime(Tm);  (*_state)[i][0] ^= Tm ^ Tmp ;
-        Tm  = (*_state)[i][1] ^ (*_state)[i][2] ; Tm = xtime(Tm);  (*_state)[i][1] ^= Tm ^ Tmp ;
-        Tm  = (*_state)[i][2] ^ (*_state)[i][3] ; Tm = xtime(Tm);  (*_state)[i][2] ^= Tm ^ Tmp ;
-        Tm  = (*_state)[i][3] ^ t ;        Tm = xtime(Tm);  (*_state)[i][3] ^= Tm ^ Tmp ;
-    }
-}
-
-// mix_columns function mixes the columns of the _state matrix.
-// The method used to multiply may be difficult to understand for the inexperienced.
-// Please use the references to gain more information.
-void SWAES<16>::inv_mix_columns(void)
-{
-    int i;
-    unsigned char a,b,c,d;
-    for(i = 0; i < 4; ++i) {
-        a = (*_state)[i][0];
-        b = (*_state)[i][1];
-        c = (*_state)[i][2];
-        d = (*_state)[i][3];
-
-        (*_state)[i][0] = multiply(a, 0x0e) ^ multiply(b, 0x0b) ^ multiply(c, 0x0d) ^ multiply(d, 0x09);
-        (*_state)[i][1] = multiply(a, 0x09) ^ multiply(b, 0x0e) ^ multiply(c, 0x0b) ^ multiply(d, 0x0d);
-        (*_state)[i][2] = multiply(a, 0x0d) ^ multiply(b, 0x09) ^ multiply(c, 0x0e) ^ multiply(d, 0x0b);
-        (*_state)[i][3] = multiply(a, 0x0b) ^ multiply(b, 0x0d) ^ multiply(c, 0x09) ^ multiply(d, 0x0e);
-    }
-}
-
-
-// The sub_bytes Function Substitutes the values in the
-// _state matrix with values in an S-box.
-void SWAES<16>::inv_sub_bytes(void)
-{
-    int i,j;
-    for(i=0;i<4;++i) {
-        for(j=0;j<4;++j) {
-            (*_state)[j][i] = rsbox[static_cast<int>((*_state)[j][i])];
-        }
-    }
-}
-
-void SWAES<16>::inv_shift_rows(void)
-{
-    unsigned char temp;
-
-    // Rotate first row 1 columns to right
-    temp            = (*_state)[3][1];
-    (*_state)[3][1] = (*_state)[2][1];
-    (*_state)[2][1] = (*_state)[1][1];
-    (*_state)[1][1] = (*_state)[0][1];
-    (*_state)[0][1] = temp;
-
-    // Rotate second row 2 columns to right
-    temp            = (*_state)[0][2];
-    (*_state)[0][2] = (*_state)[2][2];
-    (*_state)[2][2] = temp;
-
-    temp            = (*_state)[1][2];
-    (*_state)[1][2] = (*_state)[3][2];
-    (*_state)[3][2] = temp;
-
-    // Rotate third row 3 columns to right
-    temp            = (*_state)[0][3];
-    (*_state)[0][3] = (*_state)[1][3];
-    (*_state)[1][3] = (*_state)[2][3];
-    (*_state)[2][3] = (*_state)[3][3];
-    (*_state)[3][3] = temp;
-}
-
-
-// cipher is the main function that encrypts the PlainText.
-void SWAES<16>::cipher(void)
-{
-    unsigned char round = 0;
-
-    // Add the First round key to the _state before starting the rounds.
-    add_round_key(0);
-
-    // There will be Nr rounds.
-    // The first Nr-1 rounds are identical.
-    // These Nr-1 rounds are executed in the loop below.
-    for(round = 1; round < Nr; ++round) {
-        sub_bytes();
-        shift_rows();
-        mix_columns();
-        add_round_key(round);
-    }
-
-    // The last round is given below.
-    // The mix_columns function is not here in the last round.
-    sub_bytes();
-    shift_rows();
-    add_round_key(Nr);
-}
-
-void SWAES<16>::inv_cipher(void)
-{
-    unsigned char round=0;
-
-    // Add the First round key to the _state before starting the rounds.
-    add_round_key(Nr);
-
-    // There will be Nr rounds.
-    // The first Nr-1 rounds are identical.
-    // These Nr-1 rounds are executed in the loop below.
-    for(round = Nr - 1; round > 0; round--) {
-        inv_shift_rows();
-        inv_sub_bytes();
-        add_round_key(round);
-        inv_mix_columns();
-    }
-
-    // The last round is given below.
-    // The mix_columns function is not here in the last round.
-    inv_shift_rows();
-    inv_sub_bytes();
-    add_round_key(0);
-}
-
 __END_UTIL
@@ -4,34 +4,43 @@
 
 __BEGIN_UTIL
 
+// 2^128 - 2^97 - 1: used by Diffie-Hellman (secp128r1)
 template<>
 const Bignum<16>::_Word Bignum<16>::_mod = {{ 0xff, 0xff, 0xff, 0xff,
                                               0xff, 0xff, 0xff, 0xff,
                                               0xff, 0xff, 0xff, 0xff,
                                               0xfd, 0xff, 0xff, 0xff }};
 
+// 2^256 % _mod
 template<>
-const Bignum<16>::_Barrett Bignum<16>::_barrett_u = {{ 17, 0, 0, 0,
-                                                        8, 0, 0, 0,
-                                                        4, 0, 0, 0,
-                                                        2, 0, 0, 0,
-                                                        1, 0, 0, 0}};
+const Bignum<16>::_Word Bignum<16>::_montgomery_r2 = {{ 0x11, 0x00, 0x00, 0x00,
+                                                        0x08, 0x00, 0x00, 0x00,
+                                                        0x04, 0x00, 0x00, 0x00,
+                                                        0x24, 0x00, 0x00, 0x00 }};
+
+template<>
+const unsigned long long Bignum<16>::_montgomery_inverse = 0x0000000000000001ULL;
 
 
-// 2^(130) - 5: used by Poly1305
+// 2^(130) - 5: the Poly1305 prime
 template<>
 const Bignum<17>::_Word Bignum<17>::_mod = {{ 0xfb, 0xff, 0xff, 0xff,
                                               0xff, 0xff, 0xff, 0xff,
                                               0xff, 0xff, 0xff, 0xff,
                                               0xff, 0xff, 0xff, 0xff,
-                                              0x03, 0x00, 0x00, 0x00 }};
+                                              0x03, 0x00, 0x00, 0x00,
+                                              0x00, 0x00, 0x00, 0x00 }};
 
-// 0x400000000000000000000000000000005000000000000000
+// 2^384 % _mod
 template<>
-const Bignum<17>::_Barrett Bignum<17>::_barrett_u = {{ 0x00, 0x00, 0x00, 0x00,
-                                                       0x00, 0x00, 0x00, 0x50,
-                                                       0x00, 0x00, 0x00, 0x00,
-                                                       0x00, 0x00, 0x00, 0x00,
-                                                       0x00, 0x00, 0x00, 0x00,
-                                                       0x00, 0x00, 0x00, 0x40 }};
+const Bignum<17>::_Word Bignum<17>::_montgomery_r2 = {{ 0x00, 0x00, 0x00, 0x00,
+                                                        0x00, 0x00, 0x00, 0x00,
+                                                        0x00, 0x00, 0x00, 0x00,
+                                                        0x00, 0x00, 0x00, 0x90,
+                                                        0x01, 0x00, 0x00, 0x00,
+                                                        0x00, 0x00, 0x00, 0x00 }};
+
+template<>
+const unsigned long long Bignum<17>::_montgomery_inverse = 0xcccccccccccccccdULL;
+
 __END_UTIL
@@ -6,8 +6,6 @@ extern "C" { void _panic(); }
 
 __BEGIN_UTIL
 
-Simple_Spin Heap::_lock;
-
 void Heap::out_of_memory(unsigned long bytes)
 {
     db<Heaps, System>(ERR) << "Heap::alloc(this=" << this << "): out of memory while allocating " << bytes << " bytes!" << endl;
@@ -2,6 +2,6 @@
 
 __BEGIN_UTIL
 
-int Random::_seed;
+Random::Generator Random::_generators[Traits<Build>::CPUS];
 
 __END_UTIL
@@ -1,8 +1,50 @@
 // EPOS String Utility Implementation (from Newlib)
 
+// On RV32, RV64, ARMv7 and ARMv8, memcpy(), memset() and memcmp() are replaced by optimized versions (IA32 keeps the
+// Newlib ones). Whatever the compiler is told to target is used: RVV (-march=...v) handles whole buffers with
+// strip-mined vector loops, while the scalar versions align the destination with a byte prologue and then move eight
+// words per iteration, with NEON (-mfpu=neon or AArch64) taking 64-byte blocks first. Since none of these architectures
+// handles unaligned accesses efficiently (Traits<CPU>::unaligned_memory_access), a source misaligned relative to the
+// destination is read in aligned words and shifted into place. Small buffers are not worth the prologue and go byte by
+// byte. They must be defined here, in place of the Newlib ones: the linker never pulls an object out of a later library
+// just to override a weak definition it already has.
+
 #include <system/config.h>
 #include <utility/string.h>
 
+#if defined(__rv32__) || defined(__rv64__) || defined(__armv7__) || defined(__armv8__)
+
+__BEGIN_SYS
+
+// The byte loops must not be turned back into calls to the functions they implement
+#define __string_optimized__ __attribute__ ((optimize("no-tree-loop-distribute-patterns")))
+
+class String_Engine
+{
+public:
+    typedef unsigned long Word;
+
+    static const unsigned int WORD = sizeof(Word);
+    static const unsigned int UNROLL = 8;
+    static const unsigned int BLOCK = UNROLL * WORD;
+    static const unsigned int SMALL = 2 * BLOCK; // smaller buffers go byte by byte
+    static const bool little = (Traits<CPU>::ENDIANESS == Traits<CPU>::LITTLE);
+
+#ifdef __ARM_NEON
+    static const unsigned int VECTOR = 16;
+    typedef Word Vector __attribute__ ((vector_size(VECTOR), aligned(1), may_alias));
+#endif
+
+    static bool aligned(const void * p) { return !(reinterpret_cast<Word>(p) & (WORD - 1)); }
+    static Word replicate(unsigned char c) { return c * (~0UL / 0xff); }
+};
+
+__END_SYS
+
+__USING_SYS
+
+#endif
+
 extern "C"
 {
 
@@ -22,6 +64,56 @@ extern "C"
     char *itoa(int value, char *str) __attribute__ ((weak));
     int utoa(unsigned long v,char * dst) __attribute__((weak));
 
+#if defined(__rv32__) || defined(__rv64__) || defined(__armv7__) || defined(__armv8__)
+    __string_optimized__
+    int memcmp(const void * m1, const void * m2, size_t n)
+    {
+        typedef String_Engine E;
+
+        const unsigned char * s1 = reinterpret_cast<const unsigned char *>(m1);
+        const unsigned char * s2 = reinterpret_cast<const unsigned char *>(m2);
+
+#ifdef __riscv_vector
+        long i;
+        ASM("1: vsetvli  t0, %2, e8, m8, ta, ma \n"
+            "   vle8.v   v0, (%0)               \n"
+            "   vle8.v   v8, (%1)               \n"
+            "   vmsne.vv v16, v0, v8            \n"
+            "   vfirst.m %3, v16                \n"
+            "   bgez     %3, 2f                 \n"
+            "   add      %0, %0, t0             \n"
+            "   add      %1, %1, t0             \n"
+            "   sub      %2, %2, t0             \n"
+            "   bnez     %2, 1b                 \n"
+            "2:                                 \n" : "+r"(s1), "+r"(s2), "+r"(n), "=&r"(i) : : "t0", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7",
+                                                      "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15", "v16", "memory");
+        return (i < 0) ? 0 : s1[i] - s2[i];
+#endif
+
+        // Words can only be compared if both buffers can be aligned at once
+        if((n >= E::SMALL) && !((reinterpret_cast<E::Word>(s1) ^ reinterpret_cast<E::Word>(s2)) & (E::WORD - 1))) {
+            for(; !E::aligned(s1); n--, s1++, s2++)
+                if(*s1 != *s2)
+                    return *s1 - *s2;
+
+            const E::Word * a1 = reinterpret_cast<const E::Word *>(s1);
+            const E::Word * a2 = reinterpret_cast<const E::Word *>(s2);
+            for(; n >= 4 * E::WORD; n -= 4 * E::WORD, a1 += 4, a2 += 4)
+                if((a1[0] ^ a2[0]) | (a1[1] ^ a2[1]) | (a1[2] ^ a2[2]) | (a1[3] ^ a2[3]))
+                    break;
+            for(; (n >= E::WORD) && (*a1 == *a2); n -= E::WORD)
+                a1++, a2++;
+            s1 = reinterpret_cast<const unsigned char *>(a1);
+            s2 = reinterpret_cast<const unsigned char *>(a2);
+        }
+
+        for(; n--; s1++, s2++)
+            if(*s1 != *s2)
+                return *s1 - *s2;
+
+        return 0;
+    }
+#else
     int memcmp(const void * m1, const void * m2, size_t n)
     {
         unsigned char *s1 = (unsigned char *) m1;
@@ -56,7 +148,74 @@ extern "C"
         return 0;
 
     }
+#endif
+
+#if defined(__rv32__) || defined(__rv64__) || defined(__armv7__) || defined(__armv8__)
+    __string_optimized__
+    void * memcpy(void * d, const void * s, size_t n)
+    {
+        typedef String_Engine E;
+
+        unsigned char * dst = reinterpret_cast<unsigned char *>(d);
+        const unsigned char * src = reinterpret_cast<const unsigned char *>(s);
+
+#ifdef __riscv_vector
+        ASM("1: vsetvli t0, %2, e8, m8, ta, ma  \n"
+            "   vle8.v  v0, (%1)                \n"
+            "   add     %1, %1, t0              \n"
+            "   sub     %2, %2, t0              \n"
+            "   vse8.v  v0, (%0)                \n"
+            "   add     %0, %0, t0              \n"
+            "   bnez    %2, 1b                  \n" : "+r"(dst), "+r"(src), "+r"(n) : : "t0", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "memory");
+        return d;
+#endif
+
+        if(n >= E::SMALL) {
+            for(; !E::aligned(dst); n--)
+                *dst++ = *src++;
+
+            if(E::aligned(src)) {
+#ifdef __ARM_NEON
+                for(; n >= 4 * E::VECTOR; n -= 4 * E::VECTOR, dst += 4 * E::VECTOR, src += 4 * E::VECTOR) {
+                    E::Vector * vd = reinterpret_cast<E::Vector *>(dst);
+                    const E::Vector * vs = reinterpret_cast<const E::Vector *>(src);
+                    E::Vector v0 = vs[0], v1 = vs[1], v2 = vs[2], v3 = vs[3];
+                    vd[0] = v0; vd[1] = v1; vd[2] = v2; vd[3] = v3;
+                }
+#endif
+                E::Word * wd = reinterpret_cast<E::Word *>(dst);
+                const E::Word * ws = reinterpret_cast<const E::Word *>(src);
+                for(; n >= E::BLOCK; n -= E::BLOCK, wd += E::UNROLL, ws += E::UNROLL) {
+                    // All loads before the stores, so they can overlap
+                    E::Word w0 = ws[0], w1 = ws[1], w2 = ws[2], w3 = ws[3], w4 = ws[4], w5 = ws[5], w6 = ws[6], w7 = ws[7];
+                    wd[0] = w0; wd[1] = w1; wd[2] = w2; wd[3] = w3; wd[4] = w4; wd[5] = w5; wd[6] = w6; wd[7] = w7;
+                }
+                for(; n >= E::WORD; n -= E::WORD)
+                    *wd++ = *ws++;
+                dst = reinterpret_cast<unsigned char *>(wd);
+                src = reinterpret_cast<const unsigned char *>(ws);
+            } else if(E::little) {
+                // Each destination word takes the upper bytes of a source word and the lower bytes of the next one;
+                // aligned reads past the end of the source never cross a page boundary
+                unsigned int shift = (reinterpret_cast<E::Word>(src) & (E::WORD - 1)) * 8;
+                const E::Word * ws = reinterpret_cast<const E::Word *>(reinterpret_cast<E::Word>(src) & ~E::Word(E::WORD - 1));
+                E::Word * wd = reinterpret_cast<E::Word *>(dst);
+                E::Word lo = *ws++;
+                for(; n >= E::WORD; n -= E::WORD, src += E::WORD) {
+                    E::Word hi = *ws++;
+                    *wd++ = (lo >> shift) | (hi << (E::WORD * 8 - shift));
+                    lo = hi;
+                }
+                dst = reinterpret_cast<unsigned char *>(wd);
+            }
+        }
 
+        while(n--)
+            *dst++ = *src++;
+
+        return d;
+    }
+#else
     void * memcpy(void * dst0, const void * src0, size_t len0)
     {
         char *dst = reinterpret_cast<char *> (dst0);
@@ -93,6 +252,7 @@ extern "C"
         return dst0;
 
     }
+#endif
 
     void * memchr(const void * src_void, int c, size_t length)
     {
@@ -137,6 +297,54 @@ extern "C"
         return 0;
     }
 
+#if defined(__rv32__) || defined(__rv64__) || defined(__armv7__) || defined(__armv8__)
+    __string_optimized__
+    void * memset(void * m, int c, size_t n)
+    {
+        typedef String_Engine E;
+
+        unsigned char * dst = reinterpret_cast<unsigned char *>(m);
+
+#ifdef __riscv_vector
+        ASM("   vsetvli t0, zero, e8, m8, ta, ma\n"
+            "   vmv.v.x v0, %2                  \n"
+            "1: vsetvli t0, %1, e8, m8, ta, ma  \n"
+            "   vse8.v  v0, (%0)                \n"
+            "   add     %0, %0, t0              \n"
+            "   sub     %1, %1, t0              \n"
+            "   bnez    %1, 1b                  \n" : "+r"(dst), "+r"(n) : "r"(c) : "t0", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "memory");
+        return m;
+#endif
+
+        if(n >= E::SMALL) {
+            for(; !E::aligned(dst); n--)
+                *dst++ = c;
+
+            E::Word w = E::replicate(c);
+#ifdef __ARM_NEON
+            E::Vector v;
+            for(unsigned int i = 0; i < E::VECTOR / E::WORD; i++)
+                v[i] = w;
+            for(; n >= 4 * E::VECTOR; n -= 4 * E::VECTOR, dst += 4 * E::VECTOR) {
+                E::Vector * vd = reinterpret_cast<E::Vector *>(dst);
+                vd[0] = v; vd[1] = v; vd[2] = v; vd[3] = v;
+            }
+#endif
+            E::Word * wd = reinterpret_cast<E::Word *>(dst);
+            for(; n >= E::BLOCK; n -= E::BLOCK, wd += E::UNROLL) {
+                wd[0] = w; wd[1] = w; wd[2] = w; wd[3] = w; wd[4] = w; wd[5] = w; wd[6] = w; wd[7] = w;
+            }
+            for(; n >= E::WORD; n -= E::WORD)
+                *wd++ = w;
+            dst = reinterpret_cast<unsigned char *>(wd);
+        }
+
+        while(n--)
+            *dst++ = c;
+
+        return m;
+    }
+#else
     void * memset(void * m, int c, size_t n)
     {
         char *s = (char *) m;
@@ -183,6 +391,7 @@ extern "C"
 
         return m;
     }
+#endif
 
     int strcmp(const char * s1, const char * s2)
     {
@@ -19,6 +19,7 @@ template<> struct Traits<Build>: public Traits_Tokens
 
     // Default flags
     static const bool enabled = true;
+    static const bool monitored = false;
     static const bool debugged = true;
     static const bool hysterically_debugged = false;
 };
@@ -55,6 +56,13 @@ template<> struct Traits<Observers>: public Traits<Build>
     static const bool debugged = false;
 };
 
+template<> struct Traits<OStream>: public Traits<Build>
+{
+    // Buffered output formats into per-CPU rings drained by a low-priority thread, instead of busy-waiting on the Display
+    static const bool buffered = false;
+    static const unsigned int BUFFER_SIZE = 4096; // bytes per CPU
+};
+
 
 // System Parts (mostly to fine control debugging)
 template<> struct Traits<Boot>: public Traits<Build>
@@ -100,6 +108,8 @@ template<> struct Traits<System>: public Traits<Build>
 {
     static const bool multithread = (Traits<Application>::MAX_THREADS > 1);
     static const bool multiheap = Traits<Scratchpad>::enabled;
+    static const bool heap_per_core = false; // one application heap per CPU (with multiheap)
+    static const bool colorful = false; // page coloring: colored Segments and stacks take frames that partition the LLC (with a paged MMU)
     static const bool multicore = multithread && (CPUS > 1);
 
     static const unsigned long LIFE_SPAN = 1 * YEAR; // s
@@ -115,6 +125,7 @@ template<> struct Traits<Thread>: public Traits<Build>
 {
     static const bool enabled = Traits<System>::multithread;
     static const bool trace_idle = hysterically_debugged;
+    static const bool painted_stacks = false; // track stack high-water marks and detect overflows with canaries
     static const bool simulate_capacity = false;
     static const int priority_inversion_protocol = NA;
     static const int mp = Traits<System>::multicore;
@@ -138,6 +149,18 @@ template<> struct Traits<Alarm>: public Traits<Build>
     static const bool visible = hysterically_debugged;
 };
 
+template<> struct Traits<Monitor>: public Traits<Build>
+{
+    static const bool enabled = false;
+
+    static const unsigned int FREQUENCY = 10;    // Hz (per CPU)
+    static const unsigned int SAMPLES = 64;      // per-CPU ring buffer (oldest samples get overwritten)
+    static const unsigned int OVERHEAD = 10000;  // ppm of each CPU's time (samples are skipped beyond that)
+
+    static constexpr System_Event SYSTEM_EVENTS[] = {ELAPSED_TIME, DEADLINE_MISSES, CPU_EXECUTION_TIME, THREAD_EXECUTION_TIME, RUNNING_THREAD};
+    static constexpr PMU_Event PMU_EVENTS[] = {L1_INSTRUCTION_CACHE_MISSES, BRANCH_MISPREDICTIONS, LOAD_INSTRUCTIONS_RETIRED}; // mapped to the programmable channels, in order
+};
+
 template<> struct Traits<Address_Space>: public Traits<Build> {};
 
 template<> struct Traits<Segment>: public Traits<Build> {};
@@ -0,0 +1,103 @@
+// EPOS AES Throughput Benchmark
+
+// Checks AES<16> against the FIPS-197 example vector and GCM against test case 4 of the GCM specification (streamed
+// in odd pieces), then measures the throughput of single blocks (with the key schedule cached by key() and with the
+// key passed on each call, as the original interface does) and of the CTR and GCM modes over a 1 KB buffer.
+
+#include <utility/benchmark.h>
+#include <utility/gcm.h>
+#include <machine/aes.h>
+
+using namespace EPOS;
+
+typedef AES<16> Cipher;
+
+const unsigned int text_size = 1024;
+
+const unsigned char fips_key[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+const unsigned char fips_plain[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+const unsigned char fips_cipher[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+const unsigned char gcm_key[16] = { 0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08 };
+const unsigned char gcm_iv[12] = { 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88 };
+const unsigned char gcm_aad[20] = { 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+                                    0xab, 0xad, 0xda, 0xd2 };
+const unsigned char gcm_plain[60] = { 0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+                                      0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+                                      0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+                                      0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39 };
+const unsigned char gcm_tag[16] = { 0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47 };
+
+OStream cout;
+Benchmark<1000> bench_block("aes_encrypt_block");
+Benchmark<1000> bench_block_decrypt("aes_decrypt_block");
+Benchmark<1000> bench_block_rekey("aes_encrypt_block_key_per_call");
+Benchmark<100> bench_ctr("aes_ctr_1024");
+Benchmark<100> bench_gcm("aes_gcm_1024");
+
+unsigned char text[text_size];
+unsigned char out[text_size];
+
+template<unsigned int SAMPLES>
+void report(Benchmark<SAMPLES> & bench, const char * name, unsigned int bytes)
+{
+    bench.report(cout);
+    typename Benchmark<SAMPLES>::Count p50 = bench.percentile(50);
+    cout << "bench " << name << " bytes=" << bytes << " bytes_per_kcycle=" << (p50 ? bytes * 1000ULL / p50 : 0) << endl;
+}
+
+int main()
+{
+    cout << "AES Throughput Benchmark (hardware=" << Cipher::hardware << ")" << endl;
+
+    Cipher aes;
+    unsigned char block[16], plain[16];
+    aes.key(fips_key);
+    aes.encrypt(fips_plain, block);
+    aes.decrypt(block, plain);
+    bool ok = !memcmp(block, fips_cipher, 16) && !memcmp(plain, fips_plain, 16);
+    cout << "FIPS-197 vector " << (ok ? "matches." : "does not match!") << endl;
+
+    aes.key(gcm_key);
+    unsigned char sealed[60], tag[16];
+    GCM<Cipher> gcm(&aes, gcm_iv);
+    gcm.authenticate(gcm_aad, 7);
+    gcm.authenticate(gcm_aad + 7, 13);
+    gcm.encrypt(gcm_plain, sealed, 5);
+    gcm.encrypt(gcm_plain + 5, sealed + 5, 55);
+    gcm.tag(tag);
+    GCM<Cipher> opener(&aes, gcm_iv);
+    opener.authenticate(gcm_aad, 20);
+    opener.decrypt(sealed, out, 60);
+    ok = !memcmp(tag, gcm_tag, 16) && opener.verify(tag) && !memcmp(out, gcm_plain, 60);
+    cout << "GCM test case 4 " << (ok ? "matches." : "does not match!") << endl;
+    unsigned char again[16];
+    opener.tag(again);
+    ok = gcm.verify(tag) && opener.verify(tag) && !memcmp(again, gcm_tag, 16);
+    cout << "GCM tags " << (ok ? "stay the same when asked for again." : "change when asked for again!") << endl;
+
+    for(unsigned int i = 0; i < text_size; i++)
+        text[i] = i;
+
+    aes.key(fips_key);
+    bench_block.run([&]() { aes.encrypt(text, out); });
+    report(bench_block, "aes_encrypt_block", 16);
+
+    bench_block_decrypt.run([&]() { aes.decrypt(text, out); });
+    report(bench_block_decrypt, "aes_decrypt_block", 16);
+
+    // Alternating keys defeats the cache of the key schedule
+    unsigned int i = 0;
+    bench_block_rekey.run([&]() { aes.encrypt(text, (i++ % 2) ? fips_key : gcm_key, out); });
+    report(bench_block_rekey, "aes_encrypt_block_key_per_call", 16);
+
+    bench_ctr.run([&]() { CTR<Cipher> ctr(&aes, fips_plain); ctr.crypt(text, out, text_size); });
+    report(bench_ctr, "aes_ctr_1024", text_size);
+
+    bench_gcm.run([&]() { GCM<Cipher> g(&aes, gcm_iv); g.encrypt(text, out, text_size); g.tag(tag); });
+    report(bench_gcm, "aes_gcm_1024", text_size);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+// EPOS Address Space Switch Benchmark
+
+// Ping-pongs between two Address_Spaces, touching a few pages of a Segment private to each after every switch. With
+// ASIDs, the entries of both spaces stay in the TLB across switches, so a round trip should take fewer cycles and
+// TLB misses than with the TLB flushed at each switch (e.g. on MMUs without ASIDs).
+// On RISC-V, the system's MMU is No_MMU unless __sv39__ is defined (see rv64_mmu.h), so there is nothing to measure.
+
+#include <utility/benchmark.h>
+#include <architecture/pmu.h>
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+const unsigned int pages = 16;
+const unsigned long page = 4096;
+const PMU::Channel channel = PMU::FIXED;
+
+OStream cout;
+Benchmark<samples> bench("address_space_ping_pong_16_pages", Benchmark<samples>::CYCLES, 0);
+
+Address_Space * space[2];
+volatile char * data[2];
+
+void touch(volatile char * d)
+{
+    for(unsigned int i = 0; i < pages; i++)
+        d[i * page]++;
+}
+
+int main()
+{
+    cout << "Address Space Switch Benchmark" << endl;
+
+    if(MMU::PG_SIZE == 1) { // No_MMU
+        cout << "The MMU does not page on this machine, so there is nothing to measure!" << endl;
+        return 0;
+    }
+
+    Address_Space self(MMU::current());
+
+    Segment * seg[2];
+    for(unsigned int i = 0; i < 2; i++) {
+        space[i] = new (SYSTEM) Address_Space;
+        seg[i] = new (SYSTEM) Segment(pages * page, Segment::Flags(Segment::Flags::SYSD));
+        data[i] = space[i]->attach(seg[i]);
+    }
+
+    PMU::config(channel, TLB_MISSES);
+    PMU::Count misses = PMU::read(channel);
+    bench.run([]() {
+        space[0]->activate();
+        touch(data[0]);
+        space[1]->activate();
+        touch(data[1]);
+    });
+    misses = PMU::read(channel) - misses;
+
+    self.activate();
+
+    bench.report(cout);
+    cout << "bench address_space_ping_pong_16_pages tlb_misses_per_round_trip=" << misses / samples << endl;
+
+    for(unsigned int i = 0; i < 2; i++) {
+        space[i]->detach(seg[i]);
+        delete seg[i];
+        delete space[i];
+    }
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+// EPOS Big Numbers Benchmark
+
+// Measures the cycles taken by modular multiplications and exponentiations of Bignum<16> (the secp128r1 field used by
+// Diffie_Hellman) and Bignum<17> (2^130 - 5), and by a whole elliptic curve key exchange built on them, whose parties
+// must agree on the shared key.
+
+#include <utility/benchmark.h>
+#include <utility/diffie_hellman.h>
+#include <machine/aes.h>
+
+using namespace EPOS;
+
+typedef Diffie_Hellman<AES<16>> DH;
+typedef Bignum<16> Field;
+typedef Bignum<17> Poly_Field;
+
+OStream cout;
+Benchmark<1000> bench_mult16("bignum_mult_16");
+Benchmark<1000> bench_mult17("bignum_mult_17");
+Benchmark<10> bench_power16("bignum_power_16");
+Benchmark<10> bench_dh("dh_key_exchange");
+
+int main()
+{
+    cout << "Big Numbers Benchmark (digit=" << sizeof(Field::Digit) * 8 << " bits)" << endl;
+
+    DH alice, bob;
+    bool agree = (alice.shared_key(bob.public_key()) == bob.shared_key(alice.public_key()));
+    cout << "Diffie-Hellman shared keys " << (agree ? "agree." : "disagree!") << endl;
+
+    Field a, b;
+    a.randomize();
+    b.randomize();
+    bench_mult16.run([&]() { a *= b; });
+    bench_mult16.report(cout);
+
+    Poly_Field c, d;
+    c.randomize();
+    d.randomize();
+    bench_mult17.run([&]() { c *= d; });
+    bench_mult17.report(cout);
+
+    Field e;
+    e.randomize();
+    bench_power16.run([&]() { a.power(e); });
+    bench_power16.report(cout);
+
+    bench_dh.run([&]() { DH peer; peer.shared_key(alice.public_key()); });
+    bench_dh.report(cout);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
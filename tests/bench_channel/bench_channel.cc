@@ -0,0 +1,202 @@
+// EPOS Shared Memory Channel Benchmark
+
+// Passes messages from a producer to a consumer thread through the copying scheme of app/producer_consumer (a global
+// buffer guarded by two Semaphores) and through Shared_Channels, reporting the throughput of each as the ticks taken
+// to pass all messages and the latency as the round trip of a message echoed back by the other thread.
+
+#include <utility/benchmark.h>
+#include <shared_channel.h>
+#include <process.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+const unsigned int messages = 100000;
+const unsigned int SLOTS = 16;
+
+struct Message {
+    unsigned long sequence;
+    char payload[56];
+};
+
+typedef Shared_Channel<Message, SLOTS> SPSC;
+typedef Shared_Channel<Message, SLOTS, true> MPMC;
+
+OStream cout;
+Benchmark<samples> bench_copy("channel_rtt_copy", Benchmark<samples>::TSC_TICKS);
+Benchmark<samples> bench_spsc("channel_rtt_spsc", Benchmark<samples>::TSC_TICKS);
+Benchmark<samples> bench_mpmc("channel_rtt_mpmc", Benchmark<samples>::TSC_TICKS);
+
+// The copying baseline: one global buffer per direction, as in app/producer_consumer
+struct Copying {
+    Copying(): empty(SLOTS), full(0), in(0), out(0) {}
+
+    void send(const Message & m) {
+        empty.p();
+        buffer[in] = m;
+        in = (in + 1) % SLOTS;
+        full.v();
+    }
+
+    void receive(Message * m) {
+        full.p();
+        *m = buffer[out];
+        out = (out + 1) % SLOTS;
+        empty.v();
+    }
+
+    Message buffer[SLOTS];
+    Semaphore empty;
+    Semaphore full;
+    unsigned int in;
+    unsigned int out;
+};
+
+Address_Space * as;
+unsigned long checksum;
+
+template<typename Sender>
+void produce(Sender * tx)
+{
+    Message m;
+    for(unsigned int i = 0; i < messages; i++) {
+        m.sequence = i;
+        tx->send(m);
+    }
+}
+
+template<typename Receiver>
+int consume(Receiver * rx)
+{
+    Message m;
+    checksum = 0;
+    for(unsigned int i = 0; i < messages; i++) {
+        rx->receive(&m);
+        checksum += m.sequence;
+    }
+    return 0;
+}
+
+// Zero-copy variant: messages are built and read straight in the ring
+void produce_in_place(SPSC::Endpoint * tx)
+{
+    for(unsigned int i = 0; i < messages; i++) {
+        Message * m;
+        while(!(m = tx->reserve()))
+            Thread::yield();
+        m->sequence = i;
+        tx->publish();
+    }
+}
+
+int consume_in_place(SPSC::Endpoint * rx)
+{
+    checksum = 0;
+    for(unsigned int i = 0; i < messages; i++) {
+        const Message * m;
+        while(!(m = rx->peek()))
+            Thread::yield();
+        checksum += m->sequence;
+        rx->consume();
+    }
+    return 0;
+}
+
+template<typename Endpoint>
+int echo(Endpoint * rx, Endpoint * tx)
+{
+    Message m;
+    for(unsigned int i = 0; i < samples + samples / 10; i++) { // the benchmark's warmup included
+        rx->receive(&m);
+        tx->send(m);
+    }
+    return 0;
+}
+
+void report(const char * name, TSC::Time_Stamp ticks)
+{
+    const unsigned long expected = static_cast<unsigned long>(messages) * (messages - 1) / 2;
+    cout << "bench channel_throughput_" << name << " clock=tsc hz=" << TSC::frequency() << " messages=" << messages
+         << " bytes=" << sizeof(Message) << " ticks=" << ticks << (checksum == expected ? "" : " (corrupted!)") << endl;
+}
+
+template<typename Sender, typename Receiver>
+void throughput(const char * name, Sender * tx, Receiver * rx)
+{
+    Thread * consumer = new Thread(&consume<Receiver>, rx);
+    TSC::Time_Stamp t0 = TSC::time_stamp();
+    produce(tx);
+    consumer->join();
+    report(name, TSC::time_stamp() - t0);
+    delete consumer;
+}
+
+template<typename Endpoint>
+void latency(Benchmark<samples> & bench, Endpoint * ping_tx, Endpoint * ping_rx, Endpoint * pong_tx, Endpoint * pong_rx)
+{
+    Thread * echoer = new Thread(&echo<Endpoint>, ping_rx, pong_tx);
+    Message m;
+    m.sequence = 0;
+    bench.run([&]() {
+        ping_tx->send(m);
+        pong_rx->receive(&m);
+    });
+    echoer->join();
+    delete echoer;
+    bench.report(cout);
+}
+
+template<typename Channel>
+void run(const char * name, Benchmark<samples> & bench)
+{
+    Channel ping, pong;
+    typename Channel::Endpoint * ping_tx = ping.attach(as);
+    typename Channel::Endpoint * ping_rx = ping.attach(as);
+    typename Channel::Endpoint * pong_tx = pong.attach(as);
+    typename Channel::Endpoint * pong_rx = pong.attach(as);
+
+    throughput(name, ping_tx, ping_rx);
+    latency(bench, ping_tx, ping_rx, pong_tx, pong_rx);
+
+    ping.detach(ping_tx);
+    ping.detach(ping_rx);
+    pong.detach(pong_tx);
+    pong.detach(pong_rx);
+}
+
+int main()
+{
+    cout << "Shared Memory Channel Benchmark" << endl;
+
+    // Both sides share this address space here, but each gets its own Endpoint (i.e. attachment of the ring)
+    as = new (SYSTEM) Address_Space(MMU::current());
+
+    Copying * ping = new Copying;
+    Copying * pong = new Copying;
+    throughput("copy", ping, ping);
+    latency(bench_copy, ping, ping, pong, pong);
+    delete ping;
+    delete pong;
+
+    run<SPSC>("spsc", bench_spsc);
+    run<MPMC>("mpmc", bench_mpmc);
+
+    SPSC channel;
+    SPSC::Endpoint * tx = channel.attach(as);
+    SPSC::Endpoint * rx = channel.attach(as);
+    Thread * consumer = new Thread(&consume_in_place, rx);
+    TSC::Time_Stamp t0 = TSC::time_stamp();
+    produce_in_place(tx);
+    consumer->join();
+    report("spsc_zero_copy", TSC::time_stamp() - t0);
+    delete consumer;
+    channel.detach(tx);
+    channel.detach(rx);
+
+    delete as;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
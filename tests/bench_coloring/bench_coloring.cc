@@ -0,0 +1,98 @@
+// EPOS Page Coloring Benchmark
+
+// A victim thread repeatedly sweeps a buffer that fits in the share of the LLC of a single color, while one aggressor per
+// remaining partition sweeps buffers as large as the whole LLC. The victim's LLC misses are measured with the buffers in
+// shared (WHITE) memory and then in its partition's colors, where they should drop to about compulsory misses only.
+// It runs on the PC, whose paged MMU colors frames, with Traits<System>::colorful set in its own traits (without coloring
+// both runs would use WHITE memory).
+
+#include <architecture/pmu.h>
+#include <architecture/tsc.h>
+#include <memory.h>
+#include <process.h>
+
+using namespace EPOS;
+
+const unsigned int workers = Traits<Build>::CPUS; // PLLF deals one per partition
+const unsigned int rounds = 100;
+const unsigned int line = 64; // bytes
+const unsigned long llc = Traits<MMU>::LLC_SIZE;
+const unsigned long victim_size = llc / ((Traits<System>::colorful && (Traits<MMU>::COLORS > 1)) ? Traits<MMU>::COLORS : workers);
+const PMU::Channel channel = PMU::FIXED;
+
+OStream cout;
+Thread * worker[workers];
+volatile unsigned int ready;
+volatile bool done;
+
+struct Result {
+    unsigned int partition;
+    PMU::Count misses;
+    TSC::Time_Stamp cycles;
+} result;
+
+int sweep(unsigned int n, bool colored)
+{
+    unsigned int partition = Thread::self()->criterion().queue();
+    unsigned long bytes = n ? llc : victim_size;
+
+    Address_Space as(MMU::current());
+    Segment * seg = new (SYSTEM) Segment(bytes, Segment::Flags(Segment::Flags::SYSD), colored ? Segment::color(partition) : WHITE);
+    volatile char * buffer = as.attach(seg);
+    for(unsigned long i = 0; i < bytes; i += line)
+        buffer[i] = 0;
+
+    // The event must be configured on the CPU of each partition
+    PMU::config(channel, LAST_LEVEL_CACHE_MISSES);
+
+    CPU::finc(ready);
+    while(ready < workers);
+
+    if(n == 0) {
+        PMU::Count misses = PMU::read(channel);
+        TSC::Time_Stamp cycles = TSC::time_stamp();
+        for(unsigned int r = 0; r < rounds; r++)
+            for(unsigned long i = 0; i < bytes; i += line)
+                buffer[i]++;
+        result.misses = PMU::read(channel) - misses;
+        result.cycles = TSC::time_stamp() - cycles;
+        result.partition = partition;
+        done = true;
+    } else
+        while(!done)
+            for(unsigned long i = 0; i < bytes; i += line)
+                buffer[i]++;
+
+    as.detach(seg);
+    delete seg;
+
+    return 0;
+}
+
+void run(bool colored)
+{
+    ready = 0;
+    done = false;
+
+    for(unsigned int i = 0; i < workers; i++)
+        worker[i] = new Thread(&sweep, i, colored);
+    for(unsigned int i = 0; i < workers; i++) {
+        worker[i]->join();
+        delete worker[i];
+    }
+
+    cout << "bench coloring_" << (colored ? "colored" : "shared") << " partition=" << result.partition
+         << " bytes=" << victim_size << " rounds=" << rounds << " llc_misses=" << result.misses << " cycles=" << result.cycles << endl;
+}
+
+int main()
+{
+    cout << "Page Coloring Benchmark (colorful=" << Traits<System>::colorful << ",colors=" << Traits<MMU>::COLORS << ")" << endl;
+
+    run(false);
+    run(true);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// EPOS CRC Throughput Benchmark
+
+// Checks CRC-16/XMODEM, CRC-32 and CRC-32C against their standard check values, and streaming updates against whole
+// buffer computations, then measures their throughput on a minimum Ethernet frame, a full one and a 64 KB image chunk.
+// The bit-at-a-time CRC-16 loop that CRC_Engine replaced is measured as well, for reference. CRC-32 and CRC-32C use
+// the CPU's CRC instructions where CRC_Hardware has them.
+
+#include <utility/benchmark.h>
+#include <utility/string.h>
+#include <utility/crc.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 100;
+const unsigned int sizes[] = { 64, 1500, 64 * 1024 };
+const unsigned int max_size = 64 * 1024;
+
+OStream cout;
+unsigned char * buffer;
+volatile unsigned int result;
+
+unsigned short bitwise_crc16(const unsigned char * ptr, unsigned long size)
+{
+    unsigned short crc = 0;
+
+    for(; size; size--) {
+        crc ^= static_cast<unsigned short>(*ptr++) << 8;
+        for(unsigned int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+
+    return crc;
+}
+
+template<typename Engine>
+bool check(const char * name, typename Engine::Value expected)
+{
+    char digits[] = "123456789";
+
+    Engine crc;
+    crc.update(digits, 4);
+    crc.update(digits + 4, 5);
+
+    bool ok = (Engine::compute(digits, 9) == expected) && (crc.value() == expected);
+    cout << name << "(\"123456789\") = " << hex << Engine::compute(digits, 9) << dec << (ok ? " (ok)" : " (wrong!)") << endl;
+
+    return ok;
+}
+
+template<typename Operation>
+void measure(const char * function, unsigned int size, Operation op)
+{
+    char name[32];
+    strcpy(name, "crc_");
+    strcat(name, function);
+    strcat(name, "_");
+    utoa(size, name + strlen(name));
+
+    Benchmark<samples> bench(name, Benchmark<samples>::CYCLES, 1);
+    bench.run(op);
+    bench.report(cout);
+
+    Benchmark<samples>::Count p50 = bench.percentile(50);
+    cout << "bench " << name << " bytes=" << size << " bytes_per_kcycle=" << (p50 ? size * 1000ULL / p50 : 0) << endl;
+}
+
+int main()
+{
+    cout << "CRC Throughput Benchmark (hardware crc32=" << CRC_Hardware::crc32 << ",crc32c=" << CRC_Hardware::crc32c << ")" << endl;
+
+    bool ok = check<CRC16>("CRC16", 0x31c3);
+    ok = check<CRC32>("CRC32", 0xcbf43926) && ok;
+    ok = check<CRC32C>("CRC32C", 0xe3069283) && ok;
+
+    buffer = new unsigned char[max_size];
+    for(unsigned int i = 0; i < max_size; i++)
+        buffer[i] = i * 31 + 7;
+
+    if(bitwise_crc16(buffer, max_size) != CRC16::compute(buffer, max_size))
+        ok = false;
+    cout << (ok ? "CRCs are correct." : "CRCs are wrong!") << endl;
+
+    for(unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        unsigned int size = sizes[i];
+        measure("crc16_bitwise", size, [size]() { result = bitwise_crc16(buffer, size); });
+        measure("crc16", size, [size]() { result = CRC16::compute(buffer, size); });
+        measure("crc32", size, [size]() { result = CRC32::compute(buffer, size); });
+        measure("crc32c", size, [size]() { result = CRC32C::compute(buffer, size); });
+    }
+
+    delete[] buffer;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
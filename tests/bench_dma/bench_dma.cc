@@ -0,0 +1,94 @@
+// EPOS DMA Buffer Pool Microbenchmarks
+
+// Compares allocating a DMA_Buffer per transfer with taking slabs from a DMA_Pool, both for single-slab transfers and
+// for transfers that are scattered over several slabs and carried around in a Buffer, as a zero-copy stack would.
+
+#include <utility/benchmark.h>
+#include <utility/buffer.h>
+#include <machine/dma.h>
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+const unsigned int slab_size = 1536; // an Ethernet frame
+const unsigned int slabs = 64;
+const unsigned int transfer = 4 * slab_size; // for scatter-gather
+
+typedef DMA_Pool<slab_size, slabs> Pool;
+typedef DMA_Descriptor<4> Descriptor;
+typedef Buffer<Pool, Descriptor> Transfer;
+
+OStream cout;
+Benchmark<samples> bench_new("dma_buffer_new_delete");
+Benchmark<samples> bench_pool("dma_pool_alloc_free");
+Benchmark<samples> bench_new_sg("dma_buffer_new_delete_4x");
+Benchmark<samples> bench_pool_sg("dma_pool_alloc_free_sg_4x");
+
+Pool * pool;
+
+int main()
+{
+    cout << "DMA Buffer Pool Microbenchmarks" << endl;
+
+    pool = new (SYSTEM) Pool;
+    cout << "pool: " << slabs << " slabs of " << Pool::SLAB << " bytes" << endl;
+
+    CPU::Log_Addr slab[slabs];
+    unsigned int taken = 0;
+    while((taken < slabs) && (slab[taken] = pool->alloc()))
+        taken++;
+    bool exhausted = !pool->alloc();
+    cout << "slabs taken before exhaustion: " << taken << ((taken == slabs) && exhausted ? "" : " (failed!)") << endl;
+    while(taken)
+        pool->free(slab[--taken]);
+
+    bench_new.run([]() {
+        MMU::DMA_Buffer * b = new (SYSTEM) MMU::DMA_Buffer(slab_size);
+        delete b;
+    });
+    bench_new.report(cout);
+
+    bench_pool.run([]() {
+        pool->free(pool->alloc());
+    });
+    bench_pool.report(cout);
+
+    bench_new_sg.run([]() {
+        MMU::DMA_Buffer * b[4];
+        for(unsigned int i = 0; i < 4; i++)
+            b[i] = new (SYSTEM) MMU::DMA_Buffer(slab_size);
+        for(unsigned int i = 0; i < 4; i++)
+            delete b[i];
+    });
+    bench_new_sg.report(cout);
+
+    Transfer * t = new (SYSTEM) Transfer(pool, 0);
+    bench_pool_sg.run([&]() {
+        pool->alloc(t->data(), transfer);
+        pool->free(t->data());
+    });
+    bench_pool_sg.report(cout);
+
+    // A transfer scattered over slabs is gathered back intact
+    pool->alloc(t->data(), transfer);
+    for(unsigned int i = 0; i < t->data()->count(); i++)
+        memset((*t->data())[i].log, 'a' + i, (*t->data())[i].size);
+    char * flat = new char[transfer];
+    unsigned long n = t->data()->gather(flat, transfer);
+    bool ok = (n == transfer);
+    for(unsigned int i = 0; ok && (i < transfer); i++)
+        ok = (flat[i] == static_cast<char>('a' + i / slab_size));
+    cout << "scatter-gather " << *t->data() << (ok ? " ok" : " failed!") << endl;
+    pool->free(t->data());
+    delete [] flat;
+    delete t;
+
+    if(pool->available() != slabs)
+        cout << "Slabs leaked (" << pool->available() << " of " << slabs << " available)!" << endl;
+    delete pool;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
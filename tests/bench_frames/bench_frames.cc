@@ -0,0 +1,83 @@
+// EPOS MMU Frame Allocator Microbenchmarks
+
+// Measures MMU::alloc() and MMU::free() for single frames and for 2 MB blocks, and then a random mix of 1 to 64 frames,
+// reporting the free blocks of each buddy order along the way. Only the paged MMUs (IA32 and SV39) keep frames in a
+// buddy system, so it is configured for the PC: on the RISC-V machines MMU is No_MMU, which keeps its byte-sized frames
+// in a list. The IA32 port does not build in this tree, so this benchmark has not been run yet.
+
+#include <utility/benchmark.h>
+#include <utility/random.h>
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+const unsigned int slots = 128;
+const unsigned int max_frames = 64;
+const unsigned int huge_frames = 512; // a 2 MB huge page with 4 KB frames
+const unsigned long frame = 4096;
+
+OStream cout;
+Benchmark<samples> bench_single("mmu_alloc_free_1");
+Benchmark<samples> bench_huge("mmu_alloc_free_512");
+Benchmark<samples * 10> bench_stress("mmu_stress_1_to_64");
+
+CPU::Phy_Addr slot[slots];
+unsigned long size[slots];
+
+void report_orders()
+{
+    cout << "free blocks per order:";
+    for(unsigned int i = 0; i < Traits<MMU>::ORDERS; i++)
+        cout << " " << MMU::free_blocks(i);
+    cout << endl;
+}
+
+int main()
+{
+    cout << "MMU Frame Allocator Microbenchmarks" << endl;
+
+    unsigned long allocable = MMU::allocable();
+    cout << "largest free block before: " << allocable * sizeof(MMU::Page) << " bytes" << endl;
+    report_orders();
+
+    bench_single.run([]() {
+        unsigned long n = MMU::pages(frame);
+        MMU::free(MMU::alloc(n), n);
+    });
+    bench_single.report(cout);
+
+    bench_huge.run([]() {
+        unsigned long n = MMU::pages(huge_frames * frame);
+        MMU::free(MMU::alloc(n), n);
+    });
+    bench_huge.report(cout);
+
+    // Each sample either frees an occupied slot or fills an empty one with a random number of frames, so memory gets
+    // increasingly fragmented; a linear free list degrades with it, while the buddy system should stay flat
+    Random::seed(1);
+    bench_stress.run([]() {
+        unsigned int i = static_cast<unsigned int>(Random::random()) % slots;
+        if(slot[i]) {
+            MMU::free(slot[i], size[i]);
+            slot[i] = 0;
+        } else {
+            size[i] = MMU::pages((1 + static_cast<unsigned int>(Random::random()) % max_frames) * frame);
+            slot[i] = MMU::alloc(size[i]);
+        }
+    });
+    bench_stress.report(cout);
+
+    for(unsigned int i = 0; i < slots; i++)
+        if(slot[i])
+            MMU::free(slot[i], size[i]);
+
+    cout << "largest free block after: " << MMU::allocable() * sizeof(MMU::Page) << " bytes" << endl;
+    report_orders();
+    if(MMU::allocable() != allocable)
+        cout << "Free memory did not coalesce back!" << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
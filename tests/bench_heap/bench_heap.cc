@@ -0,0 +1,41 @@
+// EPOS Heap Microbenchmarks
+
+#include <utility/benchmark.h>
+#include <system.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+const unsigned int sizes[] = {16, 256, 4096};
+
+OStream cout;
+Benchmark<samples> bench_small("heap_alloc_free_16");
+Benchmark<samples> bench_medium("heap_alloc_free_256");
+Benchmark<samples> bench_large("heap_alloc_free_4096");
+Benchmark<samples> bench_system("system_heap_alloc_free_256");
+
+int main()
+{
+    cout << "Heap Microbenchmarks" << endl;
+
+    // A pinned block keeps the heap from collapsing into a single free element between samples
+    char * pinned = new char[64];
+
+    bench_small.run([]() { delete[] new char[sizes[0]]; });
+    bench_small.report(cout);
+
+    bench_medium.run([]() { delete[] new char[sizes[1]]; });
+    bench_medium.report(cout);
+
+    bench_large.run([]() { delete[] new char[sizes[2]]; });
+    bench_large.report(cout);
+
+    bench_system.run([]() { delete[] new (SYSTEM) char[sizes[1]]; });
+    bench_system.report(cout);
+
+    delete[] pinned;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// EPOS Inter-Processor Interrupt Microbenchmark
+
+#include <utility/benchmark.h>
+#include <machine/ic.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+
+OStream cout;
+Benchmark<samples> bench_ipi("ipi_round_trip", Benchmark<samples>::TSC_TICKS);
+
+volatile bool pong;
+
+// Remote CPUs answer the ping with another IPI; the BSP just flags the answer
+void ping_pong(IC::Interrupt_Id i)
+{
+    if(CPU::id() == CPU::BSP)
+        pong = true;
+    else
+        IC::ipi(CPU::BSP, IC::INT_RESCHEDULER);
+}
+
+int main()
+{
+    cout << "Inter-Processor Interrupt Microbenchmark" << endl;
+
+    if(CPU::cores() < 2) {
+        cout << "This benchmark requires at least two CPUs!" << endl;
+        return -1;
+    }
+
+    // The rescheduler IPI is borrowed while measuring, so no other thread must be active
+    IC::Interrupt_Handler rescheduler = IC::int_vector(IC::INT_RESCHEDULER);
+    IC::int_vector(IC::INT_RESCHEDULER, &ping_pong);
+
+    unsigned int target = CPU::cores() - 1;
+    bench_ipi.run([&]() {
+        pong = false;
+        IC::ipi(target, IC::INT_RESCHEDULER);
+        while(!pong);
+    });
+
+    IC::int_vector(IC::INT_RESCHEDULER, rescheduler);
+
+    bench_ipi.report(cout);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// EPOS Multiheap Benchmark
+
+// One worker per CPU allocates and frees blocks of random sizes as fast as it can, first from the application's heap
+// (one per CPU with Traits<System>::heap_per_core) and then from the system's heap, which all CPUs share. The ticks per
+// operation of the slowest worker are reported for both, so the latter shows the cost of contending for a single heap.
+// Each worker also frees a batch of blocks allocated by its neighbor, which must find their way back to the neighbor's
+// heap through the block headers.
+
+#include <utility/random.h>
+#include <architecture/tsc.h>
+#include <process.h>
+
+using namespace EPOS;
+
+const unsigned int workers = Traits<Build>::CPUS; // PLLF deals one per partition
+const unsigned int operations = 10000;
+const unsigned int batch = 16;
+const unsigned int max_size = 256;
+
+OStream cout;
+Thread * worker[workers];
+char * handed[workers][batch];
+volatile unsigned int ready;
+volatile unsigned int handed_over;
+TSC::Time_Stamp ticks[workers];
+
+int work(unsigned int n, bool shared)
+{
+    char * block[batch];
+
+    CPU::finc(ready);
+    while(ready < workers);
+
+    TSC::Time_Stamp t0 = TSC::time_stamp();
+    for(unsigned int i = 0; i < operations; i++) {
+        unsigned int j = i % batch;
+        if(i >= batch)
+            delete[] block[j];
+        unsigned int size = 1 + static_cast<unsigned int>(Random::random()) % max_size;
+        block[j] = shared ? new (SYSTEM) char[size] : new char[size];
+    }
+    ticks[n] = TSC::time_stamp() - t0;
+
+    // Blocks outlive their owner's loop and are freed by the neighbor
+    for(unsigned int j = 0; j < batch; j++)
+        handed[n][j] = block[j];
+    CPU::finc(handed_over);
+    while(handed_over < workers);
+    for(unsigned int j = 0; j < batch; j++)
+        delete[] handed[(n + 1) % workers][j];
+
+    return 0;
+}
+
+void run(bool shared)
+{
+    ready = 0;
+    handed_over = 0;
+
+    for(unsigned int i = 0; i < workers; i++)
+        worker[i] = new Thread(&work, i, shared);
+    for(unsigned int i = 0; i < workers; i++) {
+        worker[i]->join();
+        delete worker[i];
+    }
+
+    TSC::Time_Stamp max = 0;
+    for(unsigned int i = 0; i < workers; i++)
+        if(ticks[i] > max)
+            max = ticks[i];
+
+    cout << "bench multiheap_" << (shared ? "system" : "application") << " workers=" << workers << " operations=" << operations
+         << " ticks_per_op=" << max / operations << endl;
+}
+
+int main()
+{
+    cout << "Multiheap Benchmark (multiheap=" << Traits<System>::multiheap << ",heap_per_core=" << Traits<System>::heap_per_core << ")" << endl;
+
+    run(false);
+    run(true);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+// EPOS Ordered Containers Benchmark
+
+// Compares Ordered_List and Ordered_Tree holding from 16 to 4096 elements with random ranks, measuring the cycles
+// taken to insert an element, to remove it and to search for a rank. Each insertion sample adds one more element
+// (and each removal sample takes one of those out again), so sets grow by the number of samples while measured.
+// Before that, both are fed the same random sequence of insertions and removals and must end up in the same order.
+
+#include <utility/benchmark.h>
+#include <utility/list.h>
+#include <utility/random.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 100;
+const unsigned int warmup = 10;
+const unsigned int extra = samples + warmup;
+const unsigned int min_size = 16;
+const unsigned int max_size = 4096;
+const unsigned int check_elements = 500;
+const unsigned int check_operations = 20000;
+
+typedef Ordered_List<unsigned int, unsigned int> Linear;
+typedef Ordered_Tree<unsigned int, unsigned int> Balanced;
+
+OStream cout;
+unsigned int objects[check_elements];
+unsigned int ranks[extra];
+Linear::Element * linear[check_elements];
+Balanced::Element * balanced[check_elements];
+void * volatile found;
+
+bool check()
+{
+    Linear list;
+    Balanced tree;
+
+    for(unsigned int i = 0; i < check_elements; i++) {
+        objects[i] = i;
+        linear[i] = 0;
+        balanced[i] = 0;
+    }
+
+    for(unsigned int n = 0; n < check_operations; n++) {
+        unsigned int i = Random::range(check_elements);
+        if(!linear[i]) {
+            unsigned int rank = Random::range(check_elements / 4); // plenty of equal ranks
+            linear[i] = new Linear::Element(&objects[i], rank);
+            balanced[i] = new Balanced::Element(&objects[i], rank);
+            list.insert(linear[i]);
+            tree.insert(balanced[i]);
+        } else {
+            list.remove(linear[i]);
+            tree.remove(balanced[i]);
+            delete linear[i];
+            delete balanced[i];
+            linear[i] = 0;
+            balanced[i] = 0;
+        }
+
+        Linear::Element * l = list.search_rank(n % (check_elements / 4));
+        Balanced::Element * b = tree.search_rank(n % (check_elements / 4));
+        if((l ? l->object() : 0) != (b ? b->object() : 0))
+            return false;
+    }
+
+    if(list.size() != tree.size())
+        return false;
+
+    bool ok = true;
+    Linear::Iterator l = list.begin();
+    for(Balanced::Iterator b = tree.begin(); b != tree.end(); b++, l++)
+        if(b->object() != l->object())
+            ok = false;
+
+    while(!list.empty())
+        delete list.remove();
+    while(!tree.empty())
+        delete tree.remove();
+
+    return ok;
+}
+
+template<typename Operation>
+void measure(const char * container, const char * operation, unsigned int size, Operation op)
+{
+    char name[48];
+    strcpy(name, "ordered_");
+    strcat(name, container);
+    strcat(name, "_");
+    strcat(name, operation);
+    strcat(name, "_");
+    utoa(size, name + strlen(name));
+
+    Benchmark<samples> bench(name, Benchmark<samples>::CYCLES, warmup);
+    bench.run(op);
+    bench.report(cout);
+}
+
+template<typename Container>
+void measure(const char * container, unsigned int size)
+{
+    typedef typename Container::Element Element;
+
+    Container * set = new Container;
+    Element ** elements = new Element * [size + extra];
+    for(unsigned int i = 0; i < size + extra; i++) {
+        elements[i] = new Element(&objects[0], Random::range(4 * size));
+        if(i < size)
+            set->insert(elements[i]);
+    }
+    for(unsigned int i = 0; i < extra; i++)
+        ranks[i] = Random::range(4 * size);
+
+    unsigned int next = size;
+    measure(container, "insert", size, [&]() { set->insert(elements[next++]); });
+    next = size;
+    measure(container, "remove", size, [&]() { set->remove(elements[next++]); });
+    next = 0;
+    measure(container, "search", size, [&]() { found = set->search_rank(ranks[next++]); });
+
+    while(!set->empty())
+        set->remove();
+    for(unsigned int i = 0; i < size + extra; i++)
+        delete elements[i];
+    delete[] elements;
+    delete set;
+}
+
+int main()
+{
+    cout << "Ordered Containers Benchmark" << endl;
+
+    bool ok = check();
+    cout << "Ordered_Tree " << (ok ? "keeps the same order as Ordered_List." : "differs from Ordered_List!") << endl;
+
+    for(unsigned int size = min_size; size <= max_size; size *= 4) {
+        measure<Linear>("list", size);
+        measure<Balanced>("tree", size);
+    }
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+// EPOS Poly1305-AES Benchmark
+
+// Checks the tag of the first test vector of the Poly1305-AES paper and that a message fed to update() in pieces of
+// every length from 1 to 40 bytes gets the same tag as when stamped at once. Then measures tags over messages from
+// 16 B to 4 KB, reporting each size's cost distribution and the resulting throughput in bytes per thousand cycles.
+
+#include <utility/benchmark.h>
+#include <utility/poly1305.h>
+#include <machine/aes.h>
+
+using namespace EPOS;
+
+typedef Poly1305<AES<16>> MAC;
+
+const unsigned int samples = 100;
+const unsigned int min_size = 16;
+const unsigned int max_size = 4096;
+
+const unsigned char key[16] = { 0xec, 0x07, 0x4c, 0x83, 0x55, 0x80, 0x74, 0x17, 0x01, 0x42, 0x5b, 0x62, 0x32, 0x35, 0xad, 0xd6 };
+const unsigned char r[16] = { 0x85, 0x1f, 0xc4, 0x0c, 0x34, 0x67, 0xac, 0x0b, 0xe0, 0x5c, 0xc2, 0x04, 0x04, 0xf3, 0xf7, 0x00 };
+const unsigned char nonce[16] = { 0xfb, 0x44, 0x73, 0x50, 0xc4, 0xe8, 0x68, 0xc5, 0x2a, 0xc3, 0x27, 0x5c, 0xf9, 0xd4, 0x32, 0x7e };
+const unsigned char message[2] = { 0xf3, 0xf6 };
+const unsigned char tag[16] = { 0xf4, 0xc6, 0x33, 0xc3, 0x04, 0x4f, 0xc1, 0x45, 0xf8, 0x4f, 0x33, 0x5c, 0xb8, 0x19, 0x53, 0xde };
+
+OStream cout;
+unsigned char text[max_size];
+unsigned char mac[16];
+
+bool check_streaming(MAC & poly)
+{
+    for(unsigned int piece = 1; piece <= 40; piece++) {
+        unsigned int size = 1000 + piece;
+        unsigned char whole[16], streamed[16];
+
+        poly.stamp(whole, nonce, text, size);
+
+        poly.init(nonce);
+        for(unsigned int i = 0; i < size; i += piece)
+            poly.update(text + i, ((size - i) < piece) ? (size - i) : piece);
+        poly.finish(streamed);
+
+        if(memcmp(whole, streamed, sizeof(whole)))
+            return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    cout << "Poly1305-AES Benchmark" << endl;
+
+    MAC poly(key, r);
+    bool ok = poly.verify(tag, nonce, message, sizeof(message));
+    cout << "Poly1305-AES test vector " << (ok ? "matches." : "does not match!") << endl;
+
+    for(unsigned int i = 0; i < sizeof(text); i++)
+        text[i] = i * 7 + 1;
+
+    ok = check_streaming(poly);
+    cout << "Streamed tags " << (ok ? "match the whole-message ones." : "do not match the whole-message ones!") << endl;
+
+    for(unsigned int size = min_size; size <= max_size; size *= 4) {
+        char name[32];
+        strcpy(name, "poly1305_");
+        utoa(size, name + strlen(name));
+
+        Benchmark<samples> bench(name, Benchmark<samples>::CYCLES, 1);
+        bench.run([&]() { poly.stamp(mac, nonce, text, size); });
+        bench.report(cout);
+
+        Benchmark<samples>::Count p50 = bench.percentile(50);
+        cout << "bench " << name << " bytes=" << size << " bytes_per_kcycle=" << (p50 ? size * 1000ULL / p50 : 0) << endl;
+    }
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
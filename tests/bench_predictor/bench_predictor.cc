@@ -0,0 +1,176 @@
+// EPOS SmartData Predictor Benchmark
+
+// Checks that the incremental Regression recovers a known line from floating-point and from integral (fixed-point)
+// samples, that its fit over a sliding window of noisy samples matches a least-squares fit computed from scratch, that
+// a DBP fed with a line (with an integral and with a fractional slope) accepts the samples that follow its first model
+// and that a sink given that model predicts exactly what the DBP does. Then measures the cycles taken to insert a
+// sample and refit for windows from 16 to 256 samples, against recomputing the sums over the window, and the cycles
+// taken to predict 256 time points with one batch call and with one call per point.
+
+#include <utility/benchmark.h>
+#include <utility/predictor.h>
+#include <utility/random.h>
+
+using namespace EPOS;
+
+typedef unsigned long long Stamp;
+
+const unsigned int samples = 100;
+const unsigned int warmup = 10;
+const unsigned int points = 256;
+
+OStream cout;
+Stamp times[points];
+float values[points];
+volatile float result;
+
+template<unsigned int SIZE>
+using Regression = Predictor_Common::Regression<Stamp, float, SIZE>;
+
+Regression<16> regression_16;
+Regression<64> regression_64;
+Regression<256> regression_256;
+
+float noise() { return Random::range(-500, 500) / 100.0f; }
+
+bool check_line()
+{
+    Predictor_Common::Regression<Stamp, float, 64> real;
+    Predictor_Common::Regression<Stamp, int, 64> fixed;
+
+    // y = 3.5t + 20 and y = t/4 + 7, with the window sliding several times over
+    for(Stamp t = 1000000; t < 1000000 + 250 * 8; t += 8) {
+        real.insert(t, 3.5f * (t - 1000000) + 20);
+        fixed.insert(t, (t - 1000000) / 4 + 7);
+    }
+    real.fit();
+    fixed.fit();
+
+    Stamp t = 1000000 + 300 * 8;
+    float r = real.predict(t);
+    return (Math::abs(r - (3.5f * 300 * 8 + 20)) < 0.5f) && (fixed.predict(t) == 300 * 8 / 4 + 7) && (fixed.predict(t + 4) == 300 * 8 / 4 + 8);
+}
+
+// Least squares from scratch over the same window, for reference
+template<typename R>
+float refit(const R & r, Stamp t)
+{
+    double n = r.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for(unsigned int i = 0; i < r.size(); i++) {
+        double x = r[i].time() - r[0].time();
+        double y = r[i].value();
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double a = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    double b = (sy - a * sx) / n;
+    return a * (t - r[0].time()) + b;
+}
+
+bool check_window()
+{
+    Regression<64> r;
+    for(unsigned int i = 0; i < 1000; i++) {
+        Stamp t = 5000 + i * 3;
+        r.insert(t, 0.75f * i - 40 + noise());
+        if(i % 97 == 0) {
+            r.fit();
+            float error = r.predict(t + 10) - refit(r, t + 10);
+            if(Math::abs(error) > 0.01f)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool check_dbp()
+{
+    DBP<Stamp, int> dbp(32, 0, 0, 1, 0); // absolute error of 1, no tolerance for misses
+    unsigned int rebuilds = 0;
+    for(Stamp t = 0; t < 2000; t += 10)
+        if(!dbp.trickle(t, 2 * t + 100))
+            rebuilds++;
+
+    if((rebuilds != 1) || (dbp.predict(5000) != 2 * 5000 + 100))
+        return false;
+
+    // A slope below 1, which integral model coefficients would round to 0
+    DBP<Stamp, int> fraction(32, 0, 0, 1, 0);
+    rebuilds = 0;
+    for(Stamp t = 0; t < 2000; t += 10)
+        if(!fraction.trickle(t, t / 4 + 100))
+            rebuilds++;
+
+    if((rebuilds != 1) || (Math::abs(fraction.predict(5000) - (5000 / 4 + 100)) > 1))
+        return false;
+
+    // A sink given the source's model must predict exactly what the source does
+    DBP<Stamp, int> sink(32, 0, 0, 1, 0);
+    sink.update(fraction.model(), false);
+    for(Stamp t = 0; t < 10000; t += 7)
+        if(sink.predict(t) != fraction.predict(t))
+            return false;
+
+    return true;
+}
+
+template<unsigned int SIZE>
+void measure(Regression<SIZE> & r)
+{
+    for(unsigned int i = 0; i < SIZE; i++)
+        r.insert(i, i + noise());
+
+    char name[48];
+    strcpy(name, "predictor_fit_");
+    utoa(SIZE, name + strlen(name));
+
+    Stamp t = SIZE;
+    Benchmark<samples> fit(name, Benchmark<samples>::CYCLES, warmup);
+    fit.run([&]() { r.insert(t, t + noise()); r.fit(); result = r.predict(t++); });
+    fit.report(cout);
+
+    strcpy(name, "predictor_refit_");
+    utoa(SIZE, name + strlen(name));
+
+    Benchmark<samples> from_scratch(name, Benchmark<samples>::CYCLES, warmup);
+    from_scratch.run([&]() { r.insert(t, t + noise()); result = refit(r, t++); });
+    from_scratch.report(cout);
+}
+
+int main()
+{
+    cout << "SmartData Predictor Benchmark" << endl;
+
+    bool ok = check_line();
+    cout << "Lines " << (ok ? "are recovered in floating and fixed point." : "are not recovered!") << endl;
+    ok = check_window();
+    cout << "Sliding fits " << (ok ? "match the ones from scratch." : "drift from the ones from scratch!") << endl;
+    ok = check_dbp();
+    cout << "DBP " << (ok ? "follows the line after its first model and its sinks agree with it." : "keeps rebuilding its model or disagrees with its sinks!") << endl;
+
+    measure(regression_16);
+    measure(regression_64);
+    measure(regression_256);
+
+    Predictor_Common::Linear<Stamp, float> line(0.5f, 3.0f, 100);
+    for(unsigned int i = 0; i < points; i++)
+        times[i] = 100 + i * 7;
+
+    Benchmark<samples> batch("predictor_batch_256", Benchmark<samples>::CYCLES, warmup);
+    batch.run([&]() { line(times, values, points); });
+    batch.report(cout);
+
+    Benchmark<samples> single("predictor_single_256", Benchmark<samples>::CYCLES, warmup);
+    single.run([&]() { for(unsigned int i = 0; i < points; i++) result = line(times[i]); });
+    single.report(cout);
+
+    Benchmark<samples>::Count p50 = batch.percentile(50);
+    cout << "bench predictor_batch_256 points=" << points << " points_per_kcycle=" << (p50 ? points * 1000ULL / p50 : 0) << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// EPOS Lock-free Ring Buffers Benchmark
+
+// Passes items from producer to consumer threads, spread over the CPUs, through SPSC_Ring, MPMC_Ring and a
+// Blocking_Ring over MPMC_Ring, reporting the ticks taken to pass all items with 1, 2 and as many producers and
+// consumers as there are CPUs. The non-blocking rings are retried after a Thread::yield() when full or empty. The sum
+// of the items received by all consumers must match the sum of those sent.
+
+#include <utility/ring.h>
+#include <process.h>
+#include <synchronizer.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const unsigned int items = 100000;
+const unsigned int SLOTS = 64;
+const unsigned int MAX_THREADS = Traits<Build>::CPUS;
+
+typedef SPSC_Ring<unsigned long, SLOTS> SPSC;
+typedef MPMC_Ring<unsigned long, SLOTS> MPMC;
+typedef Blocking_Ring<MPMC_Ring<unsigned long, SLOTS>, Semaphore> Blocking;
+
+OStream cout;
+unsigned long sums[MAX_THREADS];
+
+template<typename Ring>
+void put(Ring * ring, unsigned long item)
+{
+    while(!ring->insert(item))
+        Thread::yield();
+}
+
+void put(Blocking * ring, unsigned long item) { ring->put(item); }
+
+template<typename Ring>
+void get(Ring * ring, unsigned long * item)
+{
+    while(!ring->remove(item))
+        Thread::yield();
+}
+
+void get(Blocking * ring, unsigned long * item) { ring->get(item); }
+
+// Producer i of n sends items i, i + n, i + 2n, ...
+template<typename Ring>
+int produce(Ring * ring, unsigned int i, unsigned int n)
+{
+    for(unsigned long item = i; item < items; item += n)
+        put(ring, item);
+    return 0;
+}
+
+template<typename Ring>
+int consume(Ring * ring, unsigned int i, unsigned int n)
+{
+    unsigned long sum = 0;
+    for(unsigned long count = i; count < items; count += n) {
+        unsigned long item;
+        get(ring, &item);
+        sum += item;
+    }
+    sums[i] = sum;
+    return 0;
+}
+
+template<typename Ring>
+void run(const char * name, unsigned int threads)
+{
+    static Ring ring; // rings are cache-line aligned, which the heap does not guarantee; each run leaves it empty
+    Thread * producers[MAX_THREADS];
+    Thread * consumers[MAX_THREADS];
+
+    TSC::Time_Stamp t0 = TSC::time_stamp();
+    for(unsigned int i = 0; i < threads; i++) {
+        consumers[i] = new Thread(&consume<Ring>, &ring, i, threads);
+        producers[i] = new Thread(&produce<Ring>, &ring, i, threads);
+    }
+    for(unsigned int i = 0; i < threads; i++) {
+        producers[i]->join();
+        consumers[i]->join();
+    }
+    TSC::Time_Stamp ticks = TSC::time_stamp() - t0;
+
+    unsigned long sum = 0;
+    for(unsigned int i = 0; i < threads; i++) {
+        sum += sums[i];
+        delete producers[i];
+        delete consumers[i];
+    }
+
+    const unsigned long expected = static_cast<unsigned long>(items) * (items - 1) / 2;
+    cout << "bench ring_throughput_" << name << "_" << threads << "x" << threads << " clock=tsc hz=" << TSC::frequency()
+         << " items=" << items << " ticks=" << ticks << (sum == expected ? "" : " (corrupted!)") << endl;
+}
+
+int main()
+{
+    cout << "Lock-free Ring Buffers Benchmark (CPUs=" << CPU::cores() << ")" << endl;
+
+    run<SPSC>("spsc", 1);
+    for(unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        run<MPMC>("mpmc", threads);
+        run<Blocking>("blocking", threads);
+    }
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
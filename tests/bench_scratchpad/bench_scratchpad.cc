@@ -0,0 +1,68 @@
+// EPOS Scratchpad Placement Benchmark
+
+// Measures the dispatch latency (a yield round trip, i.e. two context switches) between two threads whose stacks are
+// in the system's heap and then between two whose stacks are in scratchpad memory (Thread::Configuration's
+// stack_scratchpad), so each run compares the two placements. On the SiFive-U this benchmark is configured for, the
+// scratchpad is the L2 LIM and eposcc also links the scheduler's queues and the alarm's data (__SCRATCHPAD_DATA) into it;
+// to see what that is worth, compare with a build where Traits<Scratchpad>::enabled is false in sifive_u_traits.h, in
+// which both runs take their stacks from the system's heap and the hot data stays in RAM.
+
+#include <utility/benchmark.h>
+#include <machine.h>
+#include <process.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+
+OStream cout;
+Benchmark<samples> bench_ram("dispatch_round_trip_ram");
+Benchmark<samples> bench_scratchpad("dispatch_round_trip_scratchpad");
+
+volatile bool done;
+
+int yielder()
+{
+    while(!done)
+        Thread::yield();
+
+    return 0;
+}
+
+int measurer(Benchmark<samples> * bench)
+{
+    bench->run([]() { Thread::yield(); });
+    done = true;
+
+    return 0;
+}
+
+void run(Benchmark<samples> * bench, bool scratchpad)
+{
+    done = false;
+
+    Thread::Configuration conf(Thread::READY, Thread::NORMAL, Traits<Application>::STACK_SIZE, WHITE, scratchpad);
+    Thread * partner = new Thread(conf, &yielder);
+    Thread * self = new Thread(conf, &measurer, bench);
+    self->join();
+    partner->join();
+    delete self;
+    delete partner;
+
+    bench->report(cout);
+}
+
+int main()
+{
+    cout << "Scratchpad Placement Benchmark (scratchpad=" << Traits<Scratchpad>::enabled << ")" << endl;
+
+    if(!Traits<Scratchpad>::enabled)
+        cout << "No scratchpad memory in use, so both runs place stacks in the system's heap!" << endl;
+
+    run(&bench_ram, false);
+    run(&bench_scratchpad, true);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+// EPOS String Functions Bandwidth Benchmark
+
+// Measures memcpy(), memset() and memcmp() on buffers from 8 B to 1 MB, reporting each size's cost distribution and the
+// resulting bandwidth in bytes per thousand cycles (or ticks). Before that, their results are checked against plain
+// byte loops for every combination of source and destination misalignment, which exercises the word, the shift-merge
+// and the tail paths of the architecture's optimized versions.
+
+#include <utility/benchmark.h>
+#include <utility/string.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 100;
+const unsigned int min_size = 8;
+const unsigned int max_size = 1024 * 1024;
+const unsigned int check_size = 300;
+
+OStream cout;
+unsigned char * src;
+unsigned char * dst;
+volatile int result;
+
+bool check()
+{
+    for(unsigned int s = 0; s < sizeof(long); s++)
+        for(unsigned int d = 0; d < sizeof(long); d++)
+            for(unsigned int n = 0; n < check_size; n += 1 + n / 8) {
+                for(unsigned int i = 0; i < check_size + 2 * sizeof(long); i++) {
+                    src[i] = i * 7 + 1;
+                    dst[i] = 0;
+                }
+
+                memcpy(dst + d, src + s, n);
+                for(unsigned int i = 0; i < check_size + 2 * sizeof(long); i++)
+                    if(dst[i] != (((i >= d) && (i < d + n)) ? src[i - d + s] : 0))
+                        return false;
+
+                if(memcmp(dst + d, src + s, n) != 0)
+                    return false;
+                if(n) {
+                    dst[d + n - 1]++;
+                    if(memcmp(dst + d, src + s, n) <= 0)
+                        return false;
+                }
+
+                memset(dst + d, 0xa5, n);
+                for(unsigned int i = 0; i < check_size + 2 * sizeof(long); i++)
+                    if(dst[i] != (((i >= d) && (i < d + n)) ? 0xa5 : 0))
+                        return false;
+            }
+
+    return true;
+}
+
+template<typename Operation>
+void measure(const char * function, unsigned int size, Operation op)
+{
+    char name[32];
+    strcpy(name, "string_");
+    strcat(name, function);
+    strcat(name, "_");
+    utoa(size, name + strlen(name));
+
+    Benchmark<samples> bench(name, Benchmark<samples>::CYCLES, 1);
+    bench.run(op);
+    bench.report(cout);
+
+    Benchmark<samples>::Count p50 = bench.percentile(50);
+    cout << "bench " << name << " bytes=" << size << " bytes_per_kcycle=" << (p50 ? size * 1000ULL / p50 : 0) << endl;
+}
+
+int main()
+{
+    cout << "String Functions Bandwidth Benchmark" << endl;
+
+    src = new unsigned char[max_size + sizeof(long)];
+    dst = new unsigned char[max_size + sizeof(long)];
+
+    bool ok = check();
+    cout << (ok ? "memcpy(), memset() and memcmp() match the byte loops." : "memcpy(), memset() or memcmp() is wrong!") << endl;
+
+    memset(src, 0x5a, max_size + sizeof(long));
+    for(unsigned int size = min_size; size <= max_size; size *= 2) {
+        measure("memcpy", size, [size]() { memcpy(dst, src, size); });
+        measure("memcpy_misaligned", size, [size]() { memcpy(dst, src + 1, size); });
+        measure("memset", size, [size]() { memset(dst, 0x5a, size); });
+        memcpy(dst, src, size);
+        measure("memcmp", size, [size]() { result = memcmp(dst, src, size); });
+    }
+
+    delete[] src;
+    delete[] dst;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+// EPOS Thread and Synchronizer Microbenchmarks
+
+#include <utility/benchmark.h>
+#include <process.h>
+#include <synchronizer.h>
+#include <time.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 1000;
+
+OStream cout;
+Benchmark<samples> bench_yield("thread_yield_round_trip");
+Benchmark<samples> bench_mutex("mutex_lock_unlock");
+Benchmark<samples> bench_semaphore("semaphore_p_v");
+Benchmark<samples> bench_alarm("alarm_create_destroy");
+
+volatile bool done = false;
+
+int yielder()
+{
+    while(!done)
+        Thread::yield();
+
+    return 0;
+}
+
+void nothing() {}
+
+int main()
+{
+    cout << "Thread and Synchronizer Microbenchmarks" << endl;
+
+    // Each sample switches to the yielder and back, i.e. two context switches
+    Thread * partner = new Thread(&yielder);
+    bench_yield.run([]() { Thread::yield(); });
+    done = true;
+    partner->join();
+    delete partner;
+    bench_yield.report(cout);
+
+    Mutex mutex;
+    bench_mutex.run([&]() { mutex.lock(); mutex.unlock(); });
+    bench_mutex.report(cout);
+
+    Semaphore semaphore;
+    bench_semaphore.run([&]() { semaphore.p(); semaphore.v(); });
+    bench_semaphore.report(cout);
+
+    Function_Handler handler(&nothing);
+    bench_alarm.run([&]() { Alarm alarm(1000000, &handler); });
+    bench_alarm.report(cout);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+// EPOS TLB Reach Benchmark
+
+// Sweeps a large Segment touching one word per 4 KB page, so every access needs a different translation. With
+// Traits<MMU>::huge_pages, the Segment is attached with 2 MB leaf entries and should cause far fewer TLB misses than
+// with 4 KB pages (compare the output of builds with the trait on and off).
+// On RISC-V, the system's MMU is No_MMU unless __sv39__ is defined (see rv64_mmu.h), so there is nothing to measure.
+
+#include <utility/benchmark.h>
+#include <architecture/pmu.h>
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned int samples = 100;
+const unsigned long bytes = 8 * 1024 * 1024;
+const unsigned long stride = 4096;
+const PMU::Channel channel = PMU::FIXED;
+
+OStream cout;
+Benchmark<samples> bench("tlb_sweep_8M_stride_4K", Benchmark<samples>::CYCLES, 0);
+volatile char * buffer;
+
+int main()
+{
+    cout << "TLB Reach Benchmark" << endl;
+
+    if(MMU::PG_SIZE == 1) { // No_MMU
+        cout << "The MMU does not page on this machine, so there is nothing to measure!" << endl;
+        return 0;
+    }
+
+    Address_Space as(MMU::current());
+    Segment * seg = new (SYSTEM) Segment(bytes, Segment::Flags(Segment::Flags::SYSD));
+    buffer = as.attach(seg);
+    for(unsigned long i = 0; i < bytes; i += stride)
+        buffer[i] = 0;
+
+    PMU::config(channel, TLB_MISSES);
+    PMU::Count misses = PMU::read(channel);
+    bench.run([]() {
+        for(unsigned long i = 0; i < bytes; i += stride)
+            buffer[i]++;
+    });
+    misses = PMU::read(channel) - misses;
+
+    bench.report(cout);
+    cout << "bench tlb_sweep_8M_stride_4K huge_pages=" << Traits<MMU>::huge_pages << " tlb_misses_per_sweep=" << misses / samples << endl;
+
+    as.detach(seg);
+    delete seg;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+// EPOS Buddy Allocator Test Program
+
+// Runs the buddy system over an arena of 64 "frames" of 64 bytes in a plain array, so it builds and runs on any machine,
+// with or without paging. Checks that a single-frame request splits the arena into one free block of every smaller
+// order, that power-of-two requests come aligned to their size, that odd-sized requests give their surplus back, that
+// blocks handed out never overlap, and that freeing everything, in any order, coalesces the arena back into one block.
+
+#include <utility/ostream.h>
+#include <utility/buddy.h>
+#include <utility/random.h>
+
+using namespace EPOS;
+
+const unsigned long BASE = 0x1000; // address 0 means failure
+const unsigned long FRAMES = 64;
+const unsigned long FRAME_SIZE = 64;
+const unsigned int ORDERS = 7;
+const unsigned int slots = 16;
+const unsigned int operations = 10000;
+
+struct Arena
+{
+    static CPU::Log_Addr phy2log(unsigned long addr) { return &frames[addr - BASE]; }
+
+    static char frames[FRAMES * FRAME_SIZE] __attribute__((aligned(16)));
+};
+char Arena::frames[FRAMES * FRAME_SIZE];
+
+typedef Buddy_Allocator<Arena, BASE, FRAMES, FRAME_SIZE, ORDERS> Buddy;
+
+OStream cout;
+Buddy buddy;
+unsigned long slot[slots];
+unsigned long size[slots];
+bool used[FRAMES];
+
+unsigned long frame(unsigned long addr) { return (addr - BASE) / FRAME_SIZE; }
+
+bool whole() { return (buddy.size() == FRAMES) && (buddy.blocks(ORDERS - 1) == 1) && (buddy.allocable() == FRAMES); }
+
+bool check_split()
+{
+    unsigned long a = buddy.alloc(1);
+    bool ok = (a == BASE);
+    for(unsigned int k = 0; k < ORDERS - 1; k++)
+        if(buddy.blocks(k) != 1)
+            ok = false;
+
+    buddy.free(a, 1);
+    return ok && whole();
+}
+
+bool check_alignment()
+{
+    bool ok = true;
+    unsigned long one = buddy.alloc(1);
+    for(unsigned long n = 2; n <= FRAMES / 4; n *= 2) {
+        unsigned long a = buddy.alloc(n);
+        if(!a || (frame(a) % n))
+            ok = false;
+        buddy.free(a, n);
+    }
+    buddy.free(one, 1);
+
+    // 3 frames take a block of 4 and give the 4th back
+    unsigned long a = buddy.alloc(3);
+    if(!a || (buddy.size() != FRAMES - 3))
+        ok = false;
+    buddy.free(a, 3);
+
+    return ok && whole();
+}
+
+bool check_churn()
+{
+    for(unsigned int n = 0; n < operations; n++) {
+        unsigned int i = Random::range(slots);
+        if(slot[i]) {
+            for(unsigned long f = frame(slot[i]); f < frame(slot[i]) + size[i]; f++)
+                used[f] = false;
+            buddy.free(slot[i], size[i]);
+            slot[i] = 0;
+        } else {
+            size[i] = 1 + Random::range(8);
+            slot[i] = buddy.alloc(size[i]);
+            if(slot[i])
+                for(unsigned long f = frame(slot[i]); f < frame(slot[i]) + size[i]; f++) {
+                    if(used[f])
+                        return false;
+                    used[f] = true;
+                }
+        }
+    }
+
+    for(unsigned int i = 0; i < slots; i++)
+        if(slot[i])
+            buddy.free(slot[i], size[i]);
+
+    return whole();
+}
+
+int main()
+{
+    cout << "Buddy Allocator Test" << endl;
+
+    // Frames need not be freed in blocks, so give the arena back one frame at a time, from the top
+    for(unsigned long f = FRAMES; f > 0; f--)
+        buddy.free(BASE + (f - 1) * FRAME_SIZE, 1);
+    bool ok = whole();
+    cout << "Frames freed one by one " << (ok ? "coalesced into a single block." : "did not coalesce!") << endl;
+
+    ok = check_split();
+    cout << "Splitting " << (ok ? "left a free block of each smaller order." : "went wrong!") << endl;
+    ok = check_alignment();
+    cout << "Requests " << (ok ? "are aligned and give their surplus back." : "are misaligned or keep their surplus!") << endl;
+    ok = check_churn();
+    cout << "Random churn " << (ok ? "never overlapped blocks and coalesced back." : "overlapped blocks or fragmented the arena!") << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+// EPOS Lazy and Copy-on-Write Segment Test Program
+
+// Fills a lazy Segment, clones it and writes half of the clone, counting the MMU's free frames at each step: a lazy
+// Segment only takes its page tables until touched, a clone only takes its own page tables, and each page written to
+// the clone takes exactly one frame (the copy). Writing the source's pages that the clone already copied must take no
+// frames, since the source is now their only owner. Deleting the clone gives its copies back and deleting the source
+// gives back every other frame.
+// On RISC-V, the system's MMU is No_MMU unless __sv39__ is defined (see rv64_mmu.h), so there is nothing to check.
+
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned long pages = 64;
+const unsigned long page = 4096;
+const unsigned long bytes = pages * page;
+
+OStream cout;
+
+void fill(volatile char * buffer, unsigned long from, unsigned long to, char c)
+{
+    for(unsigned long i = from; i < to; i++)
+        buffer[i * page] = c;
+}
+
+bool filled(volatile char * buffer, unsigned long from, unsigned long to, char c)
+{
+    for(unsigned long i = from; i < to; i++)
+        if(buffer[i * page] != c)
+            return false;
+    return true;
+}
+
+bool check(const char * what, bool ok)
+{
+    cout << what << (ok ? "  done!" : "  failed!") << endl;
+    return ok;
+}
+
+int main()
+{
+    cout << "Lazy and Copy-on-Write Segment Test" << endl;
+
+    if(MMU::PG_SIZE == 1) { // No_MMU
+        cout << "The MMU does not page on this machine, so there is nothing to check!" << endl;
+        return 0;
+    }
+
+    Address_Space as(MMU::current());
+    bool ok = true;
+
+    unsigned long before = MMU::free_frames();
+
+    Segment * source = new (SYSTEM) Segment(bytes, Segment::Flags(Segment::Flags::SYSD | Segment::Flags::LZ));
+    volatile char * s = as.attach(source);
+    unsigned long tables = before - MMU::free_frames();
+    ok &= check("Creating a lazy segment takes only its page tables:", tables < pages);
+
+    unsigned long frames = MMU::free_frames();
+    fill(s, 0, pages, 'a'); // every page gets its frame on first access
+    ok &= check("Touching every page of it takes one frame per page:", frames - MMU::free_frames() == pages);
+
+    frames = MMU::free_frames();
+    Segment * clone = new (SYSTEM) Segment(source);
+    volatile char * c = as.attach(clone);
+    ok &= check("Cloning it takes only the clone's page tables:", frames - MMU::free_frames() < pages);
+    ok &= check("The clone shows the source's data:", filled(c, 0, pages, 'a'));
+
+    frames = MMU::free_frames();
+    fill(c, 0, pages / 2, 'b'); // only the pages written get copied
+    ok &= check("Writing half of the clone copies only those pages:", frames - MMU::free_frames() == pages / 2);
+    ok &= check("The source keeps its own data:", filled(s, 0, pages, 'a'));
+    ok &= check("The clone keeps the data it wrote and shares the rest:", filled(c, 0, pages / 2, 'b') && filled(c, pages / 2, pages, 'a'));
+
+    frames = MMU::free_frames();
+    fill(s, 0, pages / 2, 'c'); // the clone copied these pages, so the source is their only owner now
+    ok &= check("Writing the source's pages the clone copied takes no frames:", frames == MMU::free_frames());
+    ok &= check("The clone does not see those writes:", filled(c, 0, pages / 2, 'b'));
+
+    frames = MMU::free_frames();
+    as.detach(clone);
+    delete clone;
+    ok &= check("Deleting the clone gives back at least its copies:", MMU::free_frames() - frames >= pages / 2);
+    ok &= check("The source keeps the pages it shared:", filled(s, pages / 2, pages, 'a'));
+
+    as.detach(source);
+    delete source;
+    ok &= check("Deleting the source gives back every other frame:", MMU::free_frames() == before);
+
+    cout << (ok ? "All checks passed." : "Some checks failed!") << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// EPOS Heap Growth Test Program
+
+// With Traits<System>::multiheap, the system's and the application's heaps live in Segments that grow on demand. A
+// thread is created (its stack comes from the system's heap) and blocks, then both heaps are filled with patterned
+// blocks until they are twice their initial size. Every block allocated before a growth must keep its pattern, and the
+// blocked thread must wake up with its stack intact.
+
+#include <process.h>
+#include <synchronizer.h>
+
+using namespace EPOS;
+
+const unsigned int system_block = 4096;
+const unsigned int system_blocks = 2 * Traits<System>::HEAP_SIZE / system_block;
+const unsigned int application_block = 64 * 1024;
+const unsigned int application_blocks = 2 * Traits<Application>::HEAP_SIZE / application_block;
+const unsigned int stack_words = 256;
+
+OStream cout;
+Semaphore wake(0);
+char * system_memory[system_blocks];
+char * application_memory[application_blocks];
+
+bool fill(char * block, unsigned int size, char c)
+{
+    if(!block)
+        return false;
+    memset(block, c, size);
+    return true;
+}
+
+bool intact(char * block, unsigned int size, char c)
+{
+    for(unsigned int i = 0; i < size; i++)
+        if(block[i] != c)
+            return false;
+    return true;
+}
+
+int sleeper()
+{
+    volatile unsigned int word[stack_words];
+    for(unsigned int i = 0; i < stack_words; i++)
+        word[i] = i * 3;
+
+    wake.p(); // the heaps grow in the meantime
+
+    for(unsigned int i = 0; i < stack_words; i++)
+        if(word[i] != i * 3)
+            return 1;
+    return 0;
+}
+
+int main()
+{
+    cout << "Heap Growth Test" << endl;
+
+    Thread * thread = new (SYSTEM) Thread(&sleeper);
+    Thread::yield(); // let it block
+
+    bool ok = true;
+    for(unsigned int i = 0; ok && (i < system_blocks); i++) {
+        system_memory[i] = new (SYSTEM) char[system_block];
+        ok = fill(system_memory[i], system_block, i);
+        for(unsigned int j = 0; ok && (j < i); j += 7)
+            ok = intact(system_memory[j], system_block, j);
+    }
+    for(unsigned int i = 0; ok && (i < system_blocks); i++)
+        ok = intact(system_memory[i], system_block, i);
+    cout << "System's heap " << (ok ? "grew and kept its blocks." : "lost blocks when growing!") << endl;
+
+    ok = true;
+    for(unsigned int i = 0; ok && (i < application_blocks); i++) {
+        application_memory[i] = new char[application_block];
+        ok = fill(application_memory[i], application_block, i);
+        for(unsigned int j = 0; ok && (j < i); j += 7)
+            ok = intact(application_memory[j], application_block, j);
+    }
+    for(unsigned int i = 0; ok && (i < application_blocks); i++)
+        ok = intact(application_memory[i], application_block, i);
+    cout << "Application's heap " << (ok ? "grew and kept its blocks." : "lost blocks when growing!") << endl;
+
+    wake.v();
+    ok = (thread->join() == 0);
+    cout << "Stacks " << (ok ? "survived" : "did not survive") << " the growth of the system's heap." << endl;
+    delete thread;
+
+    for(unsigned int i = 0; i < system_blocks; i++)
+        delete[] system_memory[i];
+    for(unsigned int i = 0; i < application_blocks; i++)
+        delete[] application_memory[i];
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
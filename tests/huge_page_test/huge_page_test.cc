@@ -0,0 +1,76 @@
+// EPOS Huge Page Detach Test Program
+
+// Attaches 8 MB Segments, which Traits<MMU>::huge_pages maps with 2 MB leaf entries when their frames allow it, and
+// changes them after attaching: one is reflagged read-only and the other is lazy and gets all of its frames by faults.
+// Both must still be found and detached, so that attaching them again at the same address succeeds and shows the data
+// written before.
+// On RISC-V, the system's MMU is No_MMU unless __sv39__ is defined (see rv64_mmu.h), so there is nothing to check.
+
+#include <memory.h>
+
+using namespace EPOS;
+
+const unsigned long bytes = 8 * 1024 * 1024;
+const unsigned long stride = 4096;
+
+OStream cout;
+
+bool filled(volatile char * buffer, char c)
+{
+    for(unsigned long i = 0; i < bytes; i += stride)
+        if(buffer[i] != c)
+            return false;
+    return true;
+}
+
+bool check_reflag(Address_Space & as)
+{
+    Segment * seg = new (SYSTEM) Segment(bytes, Segment::Flags(Segment::Flags::SYSD));
+    char * buffer = as.attach(seg);
+    for(unsigned long i = 0; i < bytes; i += stride)
+        buffer[i] = 'r';
+
+    seg->reflag(Segment::Flags::SYSC);
+    as.detach(seg);
+    bool ok = (as.attach(seg, buffer) == buffer) && filled(buffer, 'r');
+
+    as.detach(seg, buffer);
+    delete seg;
+    return ok;
+}
+
+bool check_lazy(Address_Space & as)
+{
+    Segment * seg = new (SYSTEM) Segment(bytes, Segment::Flags(Segment::Flags::SYSD | Segment::Flags::LZ));
+    char * buffer = as.attach(seg);
+    for(unsigned long i = 0; i < bytes; i += stride)
+        buffer[i] = 'l'; // every page gets its frame on first access
+
+    as.detach(seg, buffer);
+    bool ok = (as.attach(seg, buffer) == buffer) && filled(buffer, 'l');
+
+    as.detach(seg);
+    delete seg;
+    return ok;
+}
+
+int main()
+{
+    cout << "Huge Page Detach Test" << endl;
+
+    if(MMU::PG_SIZE == 1) { // No_MMU
+        cout << "The MMU does not page on this machine, so there is nothing to check!" << endl;
+        return 0;
+    }
+
+    Address_Space as(MMU::current());
+
+    bool ok = check_reflag(as);
+    cout << "Reflagged segments " << (ok ? "are detached." : "stay attached!") << endl;
+    ok = check_lazy(as);
+    cout << "Lazy segments filled by faults " << (ok ? "are detached." : "stay attached!") << endl;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
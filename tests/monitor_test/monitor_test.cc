@@ -0,0 +1,96 @@
+// EPOS Monitor Test Program
+
+// Traits<Monitor>::enabled starts one sampler thread per CPU. Two periodic threads run under RM next to them, with
+// enough slack for every job to meet its deadline. Samplers run below every real-time job, so they must not take part
+// in the schedule: no deadline may be missed and every job released must finish. Meanwhile, the samplers must have
+// filled their buffers with samples of increasing time stamps and elapsed times.
+
+#include <time.h>
+#include <real-time.h>
+#include <monitor.h>
+
+using namespace EPOS;
+
+const unsigned int iterations = 20;
+const unsigned int period_a = 50; // ms
+const unsigned int period_b = 100; // ms
+const unsigned int wcet_a = 10; // ms
+const unsigned int wcet_b = 20; // ms
+
+OStream cout;
+Chronometer chrono;
+
+void exec(unsigned int time) // in miliseconds
+{
+    // Busy waiting, so the periodic threads keep the CPU for their whole execution time
+    for(Microsecond end = chrono.read() + time * 1000; chrono.read() < end;);
+}
+
+int func_a()
+{
+    do {
+        exec(wcet_a);
+    } while(Periodic_Thread::wait_next());
+
+    return 0;
+}
+
+int func_b()
+{
+    do {
+        exec(wcet_b);
+    } while(Periodic_Thread::wait_next());
+
+    return 0;
+}
+
+bool check_jobs(Periodic_Thread * thread)
+{
+    volatile Thread::Criterion::Statistics & s = thread->criterion().statistics();
+    return (s.jobs_released >= iterations) && (s.jobs_finished == s.jobs_released) && (s.deadline_misses == 0);
+}
+
+bool check_samples(unsigned int cpu)
+{
+    if(!Monitor::samples(cpu))
+        return false;
+
+    // ELAPSED_TIME is the first system event in Traits<Monitor>
+    for(unsigned int i = 1; i < Monitor::samples(cpu); i++)
+        if((Monitor::sample(cpu, i).time_stamp <= Monitor::sample(cpu, i - 1).time_stamp)
+           || (Monitor::sample(cpu, i).data[0] < Monitor::sample(cpu, i - 1).data[0]))
+            return false;
+    return true;
+}
+
+int main()
+{
+    cout << "Monitor Test" << endl;
+
+    chrono.start();
+
+    Periodic_Thread * thread_a = new Periodic_Thread(RTConf(period_a * 1000, 0, 0, 0, iterations), &func_a);
+    Periodic_Thread * thread_b = new Periodic_Thread(RTConf(period_b * 1000, 0, 0, 0, iterations), &func_b);
+    thread_a->join();
+    thread_b->join();
+
+    chrono.stop();
+
+    bool ok = check_jobs(thread_a) && check_jobs(thread_b) && (Real_Time_Scheduler_Common::deadline_misses() == 0);
+    cout << "Periodic threads " << (ok ? "kept their schedule" : "were disturbed") << " next to the samplers." << endl;
+
+    ok = true;
+    for(unsigned int cpu = 0; cpu < Traits<Build>::CPUS; cpu++)
+        ok = ok && check_samples(cpu);
+    cout << "Samplers " << (ok ? "filled their buffers in order." : "did not sample as expected!") << endl;
+
+    cout << "\nMonitor samples (cpu,time_stamp,system events...,pmu events...):" << endl;
+    Monitor::dump(cout);
+
+    delete thread_a;
+    delete thread_b;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+// EPOS Output Buffer Test Program
+
+// With Traits<OStream>::buffered, two threads per CPU print numbered lines made of their own letter, more of them than a
+// CPU's ring holds, so rings fill up and get written out synchronously while the drainer is also busy. Every line must
+// come out whole, with each thread's lines in order, and the last lines of every thread, still buffered when they exit,
+// must come out before the machine halts.
+
+#include <process.h>
+
+using namespace EPOS;
+
+const unsigned int THREADS = 2 * Traits<Build>::CPUS;
+const unsigned int lines = 64;
+const unsigned int width = 96;
+
+OStream cout;
+Thread * threads[THREADS];
+
+int print(unsigned int id)
+{
+    char text[width + 1];
+    for(unsigned int i = 0; i < width; i++)
+        text[i] = 'a' + id;
+    text[width] = 0;
+
+    for(unsigned int i = 0; i < lines; i++)
+        cout << "T" << id << " L" << i << " " << text << endl;
+
+    return 0;
+}
+
+int main()
+{
+    cout << "Output Buffer Test" << endl;
+    cout << THREADS << " threads will print " << lines << " lines each." << endl;
+
+    for(unsigned int i = 0; i < THREADS; i++)
+        threads[i] = new Thread(&print, i);
+    for(unsigned int i = 0; i < THREADS; i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
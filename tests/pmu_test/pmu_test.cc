@@ -0,0 +1,89 @@
+// EPOS PMU Virtualization Test Program
+
+// Two threads with per-thread PMU counters take turns on a single CPU: a light one runs a short loop, blocks while a
+// heavy one runs a loop a thousand times longer, and then runs its loop again. The light thread's count of retired
+// instructions must keep what it had before blocking, must not grow by the heavy thread's loop while blocked, and must
+// grow again once the light thread is back; the heavy thread's count must cover its own loop.
+
+#include <process.h>
+#include <synchronizer.h>
+
+using namespace EPOS;
+
+const PMU::Channel channel = 2; // instructions retired
+const unsigned int light = 1000;
+const unsigned int heavy = 1000000;
+
+OStream cout;
+Semaphore go(0);
+Semaphore done(0);
+volatile unsigned int sink;
+
+PMU::Count light_before, light_after, light_final, heavy_count;
+
+void work(unsigned int iterations)
+{
+    for(unsigned int i = 0; i < iterations; i++)
+        sink = i;
+}
+
+int light_thread()
+{
+    Thread::self()->pmu_enable();
+
+    work(light);
+    light_before = Thread::self()->pmu_read(channel);
+
+    go.v();
+    done.p(); // the heavy thread runs in the meantime
+
+    light_after = Thread::self()->pmu_read(channel);
+    work(light);
+    light_final = Thread::self()->pmu_read(channel);
+
+    return 0;
+}
+
+int heavy_thread()
+{
+    Thread::self()->pmu_enable();
+
+    go.p();
+    work(heavy);
+    heavy_count = Thread::self()->pmu_read(channel);
+    done.v();
+
+    return 0;
+}
+
+int main()
+{
+    cout << "PMU Virtualization Test" << endl;
+
+    PMU::Count total = PMU::read(channel);
+
+    Thread * h = new Thread(&heavy_thread);
+    Thread * l = new Thread(&light_thread);
+    l->join();
+    h->join();
+
+    total = PMU::read(channel) - total;
+
+    cout << "light: before=" << light_before << " after=" << light_after << " final=" << light_final << endl;
+    cout << "heavy: " << heavy_count << ", whole CPU: " << total << endl;
+
+    bool survived = (light_after >= light_before) && (light_before >= light);
+    bool isolated = (light_after - light_before < heavy) && (heavy_count >= heavy) && (total >= heavy_count + light_final);
+    bool resumed = (light_final - light_after >= light);
+
+    cout << "Counts " << (survived ? "survive" : "do not survive") << " context switches." << endl;
+    cout << "Counts " << (isolated ? "exclude" : "include") << " other threads' events." << endl;
+    cout << "Counts " << (resumed ? "resume" : "do not resume") << " when the thread runs again." << endl;
+
+    delete l;
+    delete h;
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
@@ -17,6 +17,7 @@ int func_a();
 int func_b();
 int func_c();
 long max(unsigned int a, unsigned int b, unsigned int c) { return ((a >= b) && (a >= c)) ? a : ((b >= a) && (b >= c) ? b : c); }
+void report(char c, Periodic_Thread * thread);
 
 OStream cout;
 Chronometer chrono;
@@ -84,11 +85,30 @@ int main()
          << max(period_a, period_b, period_c) * iterations
          << " ms. The measured time was " << chrono.read() / 1000 <<" ms!" << endl;
 
+    cout << "\nPer-thread statistics (in ticks):" << endl;
+    report('A', thread_a);
+    report('B', thread_b);
+    report('C', thread_c);
+
     cout << "I'm also done, bye!" << endl;
 
     return 0;
 }
 
+void report(char c, Periodic_Thread * thread)
+{
+    Thread::Criterion::Statistics s = thread->statistics();
+
+    cout << c << ": jobs=" << s.jobs_finished << "/" << s.jobs_released
+         << ", misses=" << s.deadline_misses
+         << ", response={min=" << s.response_time_min << ",avg=" << s.response_time_avg() << ",max=" << s.response_time_max << ",jitter=" << s.response_time_jitter() << "}"
+         << ", start_jitter=" << s.start_jitter()
+         << ", execution=" << s.thread_execution_time << " {";
+    for(unsigned int i = 0; i < Traits<Build>::CPUS; i++)
+        cout << (i ? "," : "") << s.execution_per_cpu[i];
+    cout << "}" << endl;
+}
+
 int func_a()
 {
     exec('A');
@@ -0,0 +1,60 @@
+// EPOS Thread Stack Usage Test Program
+
+// Threads recurse to different depths, each level taking a known amount of stack, and their high-water marks must
+// grow with the depth. The stack report printed at the end recommends a stack size for each of them.
+
+#include <process.h>
+
+using namespace EPOS;
+
+const unsigned int threads = 4;
+const unsigned int frame = 512; // bytes of locals per recursion level
+
+OStream cout;
+
+int recurse(unsigned int depth)
+{
+    volatile char locals[frame];
+    for(unsigned int i = 0; i < frame; i++)
+        locals[i] = depth;
+
+    return depth ? recurse(depth - 1) + locals[0] : locals[frame - 1];
+}
+
+int worker(unsigned int depth)
+{
+    recurse(depth);
+    cout << "Thread " << Thread::self() << " recursed " << depth << " levels: high-water mark is " << Thread::self()->stack_high_water() << " bytes" << endl;
+    return Thread::self()->stack_high_water();
+}
+
+int main()
+{
+    cout << "Thread Stack Usage Test" << endl;
+
+    if(!Traits<Thread>::painted_stacks) {
+        cout << "This test requires Traits<Thread>::painted_stacks!" << endl;
+        return -1;
+    }
+
+    bool ok = true;
+    unsigned int previous = 0;
+    for(unsigned int i = 0; i < threads; i++) {
+        unsigned int depth = i * 4;
+        Thread * t = new Thread(&worker, depth);
+        unsigned int used = t->join();
+        delete t;
+
+        if(used < depth * frame || used <= previous)
+            ok = false;
+        previous = used;
+    }
+
+    cout << (ok ? "High-water marks grow with stack depth." : "High-water marks are wrong!") << endl;
+
+    Thread::stack_report(cout);
+
+    cout << "I'm done, bye!" << endl;
+
+    return 0;
+}
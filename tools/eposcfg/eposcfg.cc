@@ -22,7 +22,7 @@ using namespace EPOS::S;
 using namespace EPOS::S::U;
 
 // Constants
-const unsigned int TOKENS = 29;
+const unsigned int TOKENS = 30;
 const unsigned int COMPONENTS = 62;
 const unsigned int STRING_SIZE = 128;
 
@@ -56,6 +56,7 @@ char tokens[TOKENS][STRING_SIZE] = {
     "SYS_DATA_ADDR",
     "SYS_STACK_ADDR",
     "SYS_HEAP_ADDR",
+    "SCRATCHPAD_ADDR",
     "EXPECTED_SIMULATION_TIME"
 };
 
@@ -308,6 +309,12 @@ void populate_strings()
         string[0] = '\0';
     set_token_value("SYS_HEAP_ADDR", string);
 
+    if(Memory_Map::SCRATCHPAD != Memory_Map::NOT_USED)
+        snprintf(string, STRING_SIZE, xformat, Memory_Map::SCRATCHPAD);
+    else
+        string[0] = '\0';
+    set_token_value("SCRATCHPAD_ADDR", string);
+
     snprintf(string, STRING_SIZE, "%i", Traits<Build>::EXPECTED_SIMULATION_TIME);
     set_token_value("EXPECTED_SIMULATION_TIME", string);
 